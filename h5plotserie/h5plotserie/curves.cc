@@ -110,13 +110,13 @@ void Curves::collectFilesToRefresh(std::set<H5::File*> &filesToRefresh) {
 }
 
 void Curves::refreshAllTabs() {
-  int currentTab=currentIndex();
-  int numberOfTabs=count();
-  for (int i=0; i<numberOfTabs; i++) {
-    setCurrentIndex(i);
-    plotCurrentTab();
+  // the curves of all tabs are up to date with the plot data tables (see plotCurrentTab): just append the new rows
+  PlotArea *plotArea=static_cast<MainWindow*>(parent()->parent())->getPlotArea();
+  for (int i=0; i<count(); i++) {
+    auto * plotWindow = plotArea->findChild<PlotWindow*>(tabText(i));
+    if (plotWindow)
+      plotWindow->refreshDataSets();
   }
-  setCurrentIndex(currentTab);
 }
 
 void Curves::plotCurrentTab() {
@@ -29,8 +29,136 @@
 #include <qwt_plot_curve.h>
 #include <qwt_plot_zoomer.h>
 #include <qwt_plot_grid.h>
+#include <qwt_series_data.h>
+#include <qwt_scale_div.h>
 
 #include <hdf5serie/vectorserie.h>
+#include <algorithm>
+#include <cmath>
+
+// The samples of a curve. New rows are appended to the x and y values, without copying the existing samples
+// (as QwtPlotCurve::setSamples would do), so a refresh costs only time proportional to the new rows.
+// For x values in ascending order the samples can be decimated to the visible x range and the canvas width,
+// see decimate.
+class CurveData : public QwtSeriesData<QPointF> {
+  public:
+    size_t size() const override { return decimated ? idx.size() : x.size(); }
+    QPointF sample(size_t i) const override {
+      if (decimated)
+        i=idx[i];
+      // NaN values are drawn at the middle of the value range
+      return QPointF(std::isnan(x[i]) ? rect.center().x() : x[i], std::isnan(y[i]) ? rect.center().y() : y[i]);
+    }
+    QRectF boundingRect() const override { return rect; }
+
+    void clear() {
+      x.clear();
+      y.clear();
+      idx.clear();
+      decimated=false;
+      m4=false;
+      sorted=true;
+      xMin=yMin=99e99;
+      xMax=yMax=-99e99;
+      rect=QRectF(0.0, 0.0, -1.0, -1.0);
+    }
+
+    void append(const std::vector<double> &newX, const std::vector<double> &newY) {
+      for (size_t i=0; i<newX.size(); i++) {
+        if (std::isnan(newX[i]) || (!x.empty() && newX[i]<x.back()))
+          sorted=false;
+        x.push_back(newX[i]);
+        y.push_back(newY[i]);
+        if (!std::isnan(newX[i])) {
+          xMin=std::min(xMin, newX[i]);
+          xMax=std::max(xMax, newX[i]);
+        }
+        if (!std::isnan(newY[i])) {
+          yMin=std::min(yMin, newY[i]);
+          yMax=std::max(yMax, newY[i]);
+        }
+      }
+      if (xMin<=xMax && yMin<=yMax)
+        rect=QRectF(QPointF(xMin, yMin), QPointF(xMax, yMax));
+    }
+
+    // Reduce the samples to the points in the x range [x0, x1] (plus one neighbour on each side) and, if these
+    // are more than 4 per pixel, to the first, minimal, maximal and last point of each of the pixels columns
+    // (M4 decimation). The drawn curve is the same as with all points, but the number of samples is bounded by
+    // the canvas width. If the x values are not in ascending order all samples are used.
+    // If only rows were appended since the last call with the same x range and width, the M4 result is kept and
+    // only the pixel columns touched by the new rows are updated.
+    void decimate(double x0, double x1, int pixels) {
+      if (!sorted || x.size()<=4*static_cast<size_t>(pixels)) {
+        idx.clear();
+        decimated=false;
+        m4=false;
+        return;
+      }
+      size_t first=std::lower_bound(x.begin(), x.end(), x0)-x.begin();
+      size_t last=std::upper_bound(x.begin(), x.end(), x1)-x.begin();
+      if (first>0)
+        first--;
+      if (last<x.size())
+        last++;
+      if (m4 && x0==m4X0 && x1==m4X1 && pixels==m4Pixels && first==m4First && last>=m4Last) {
+        // the columns before the last one are complete: recompute the last one and add the new ones
+        idx.resize(tailIdx);
+        decimateColumns(tailBegin, last, x0, pixels/(x1-x0));
+        m4Last=last;
+        return;
+      }
+      idx.clear();
+      decimated=true;
+      m4=false;
+      if (last-first<=4*static_cast<size_t>(pixels) || !(x1>x0)) {
+        for (size_t i=first; i<last; i++)
+          idx.push_back(i);
+        return;
+      }
+      decimateColumns(first, last, x0, pixels/(x1-x0));
+      m4=true;
+      m4X0=x0;
+      m4X1=x1;
+      m4Pixels=pixels;
+      m4First=first;
+      m4Last=last;
+    }
+
+  private:
+    // append the M4 samples of the pixel columns of the samples [i, last[ to idx
+    void decimateColumns(size_t i, size_t last, double x0, double scale) {
+      while (i<last) {
+        const double column=std::floor((x[i]-x0)*scale);
+        size_t begin=i, minI=i, maxI=i;
+        for (; i<last && std::floor((x[i]-x0)*scale)==column; i++) {
+          if (!std::isnan(y[i]) && (std::isnan(y[minI]) || y[i]<y[minI]))
+            minI=i;
+          if (!std::isnan(y[i]) && (std::isnan(y[maxI]) || y[i]>y[maxI]))
+            maxI=i;
+        }
+        tailBegin=begin;
+        tailIdx=idx.size();
+        size_t column4[]={begin, std::min(minI, maxI), std::max(minI, maxI), i-1};
+        for (size_t j : column4)
+          if (idx.empty() || idx.back()!=j)
+            idx.push_back(j);
+      }
+    }
+
+    std::vector<double> x, y;
+    std::vector<size_t> idx; // indices of the decimated samples
+    bool decimated{false};
+    // the parameters of the last M4 decimation (m4=false if none) and the start of its last pixel column
+    // (the sample tailBegin, stored from idx[tailIdx] on) which new rows may extend
+    bool m4{false};
+    double m4X0{0}, m4X1{0};
+    int m4Pixels{0};
+    size_t m4First{0}, m4Last{0}, tailBegin{0}, tailIdx{0};
+    bool sorted{true}; // x values are in ascending order
+    double xMin{99e99}, yMin{99e99}, xMax{-99e99}, yMax{-99e99};
+    QRectF rect{0.0, 0.0, -1.0, -1.0};
+};
 
 PlotArea::PlotArea(QWidget * parent) : QMdiArea(parent) {
   setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
@@ -54,6 +182,10 @@ PlotWindow::PlotWindow(QWidget * parent) : QMdiSubWindow(parent) {
   plot->replot();
 
   zoom = new QwtPlotZoomer(plot->canvas());
+  connect(zoom, &QwtPlotZoomer::zoomed, this, [this](const QRectF &) {
+    decimateCurves();
+    plot->replot();
+  });
 
   uint linewidth=1;
   pen.append(QPen(Qt::red, linewidth));
@@ -76,6 +208,9 @@ void PlotWindow::detachPlot() {
   QwtPlotItemList il = plot->itemList();
   for(auto & i : il)
     i->detach();
+  for(auto & c : curves)
+    delete c.curve;
+  curves.clear();
   plot->replot();
   xMinValue=99e99;
   xMaxValue=-99e99;
@@ -84,84 +219,80 @@ void PlotWindow::detachPlot() {
 }
 
 void PlotWindow::plotDataSet(PlotData pd, int penColor) {
+  Curve c;
+  c.pd=pd;
+  c.data=new CurveData;
+  c.curve=new QwtPlotCurve();
+  c.curve->setData(c.data);
+  readNewRows(c);
+  c.curve->attach(plot);
+  while (penColor>pen.size()-1)
+    penColor-=pen.size();
+  c.curve->setPen(pen[penColor]);
+  curves.push_back(c);
+}
+
+void PlotWindow::readNewRows(Curve &c) {
+  PlotData &pd=c.pd;
   DataSelection *dataSelection=static_cast<MainWindow*>(parent()->parent()->parent())->getDataSelection();
   std::shared_ptr<H5::File> h5file=dataSelection->getH5File(QString(pd.getValue("Filepath")+"/"+pd.getValue("Filename")).toStdString());
 
-  auto *vs=h5file->openChildObject<H5::VectorSerie<double> >(pd.getValue("x-Path").toStdString());
-  size_t rows=vs->getRows();
-  std::vector<double> xVal(rows);
-  vs->getColumn(pd.getValue("x-Index").toInt(), xVal);
-
-  vs=h5file->openChildObject<H5::VectorSerie<double> >(pd.getValue("y-Path").toStdString());
-  std::vector<double> yVal(rows);
-  vs->getColumn(pd.getValue("y-Index").toInt(), yVal);
-
-  std::vector<double> y2Val(rows);
-  bool useY2=false;
-  if (pd.getValue("y2-Path").length()>0) {
-    vs=h5file->openChildObject<H5::VectorSerie<double> >(pd.getValue("y2-Path").toStdString());
-    vs->getColumn(pd.getValue("y2-Index").toInt(), y2Val);
-    useY2=true;
-  }
+  auto *xs=h5file->openChildObject<H5::VectorSerie<double> >(pd.getValue("x-Path").toStdString());
+  auto *ys=h5file->openChildObject<H5::VectorSerie<double> >(pd.getValue("y-Path").toStdString());
+  H5::VectorSerie<double> *y2s=nullptr;
+  if (pd.getValue("y2-Path").length()>0)
+    y2s=h5file->openChildObject<H5::VectorSerie<double> >(pd.getValue("y2-Path").toStdString());
 
-  if (xVal.size()==yVal.size()) {
+  // the datasets of a live file may lag behind each other: use only the rows available in all datasets
+  size_t rows=std::min(xs->getRows(), ys->getRows());
+  if (y2s)
+    rows=std::min<size_t>(rows, y2s->getRows());
+  if (rows<c.rows) { // the file was rewritten: read all rows again
+    c.data->clear();
+    c.rows=0;
+  }
+  if (rows==c.rows)
+    return;
 
-    for (double i : xVal)
-      if (!std::isnan(i)) { // xValue
-        if (i<xMinValue)
-          xMinValue=i;
-        if (i>xMaxValue)
-          xMaxValue=i;
-      }
+  // read only the new rows of the x, y and y2 columns
+  int count=rows-c.rows;
+  std::vector<double> xVal(count), yVal(count), y2Val;
+  xs->getRowRange(c.rows, count, {pd.getValue("x-Index").toInt()}, count, xVal.data());
+  ys->getRowRange(c.rows, count, {pd.getValue("y-Index").toInt()}, count, yVal.data());
+  if (y2s) {
+    y2Val.resize(count);
+    y2s->getRowRange(c.rows, count, {pd.getValue("y2-Index").toInt()}, count, y2Val.data());
+  }
 
-    if (useY2) {
-      if ((yVal.size()==y2Val.size())) {
-        const double y2offset=pd.getValue("y2offset").toDouble();
-        const double y2gain=pd.getValue("y2gain").toDouble();
-        for (double & i : y2Val)
-          if (!std::isnan(i)) // y2Value
-            i=y2gain*(i+y2offset);
-      }
-      else {
-        useY2=false;
-        QMessageBox msgBox;
-        msgBox.setText("Different sizes of y- and y2-Vector. I'm going to skip y2 data.");
-        msgBox.exec();
-      }
+  const double offset=pd.getValue("offset").toDouble();
+  const double gain=pd.getValue("gain").toDouble();
+  const double y2offset=pd.getValue("y2offset").toDouble();
+  const double y2gain=pd.getValue("y2gain").toDouble();
+  for (int i=0; i<count; i++) {
+    yVal[i]=gain*(yVal[i]+offset);
+    if (y2s)
+      yVal[i]+=y2gain*(y2Val[i]+y2offset);
+    if (!std::isnan(xVal[i])) {
+      xMinValue=std::min(xMinValue, xVal[i]);
+      xMaxValue=std::max(xMaxValue, xVal[i]);
     }
-
-    const double offset=pd.getValue("offset").toDouble();
-    const double gain=pd.getValue("gain").toDouble();
-    for (unsigned int i=0; i<yVal.size(); i++)
-      if (!std::isnan(yVal[i])) { // yValue
-        yVal[i]=gain*(yVal[i]+offset);
-        if (useY2)
-          yVal[i]+=y2Val[i];
-        if (yVal[i]<yMinValue)
-          yMinValue=yVal[i];
-        if (yVal[i]>yMaxValue)
-          yMaxValue=yVal[i];
-      }
-
-    for (unsigned int i=0; i<xVal.size(); i++) {
-      if (std::isnan(xVal[i]))
-        xVal[i]=.5*(xMinValue+xMaxValue);
-      if (std::isnan(yVal[i]))
-        yVal[i]=.5*(yMinValue+yMaxValue);
+    if (!std::isnan(yVal[i])) {
+      yMinValue=std::min(yMinValue, yVal[i]);
+      yMaxValue=std::max(yMaxValue, yVal[i]);
     }
-
-    QwtPlotCurve * c = new QwtPlotCurve();
-    c->attach(plot);
-    while (penColor>pen.size()-1)
-      penColor-=pen.size();
-    c->setPen(pen[penColor]);
-    c->setSamples(&xVal[0], &yVal[0], xVal.size());
-  }
-  else {
-    QMessageBox msgBox;
-    msgBox.setText("Different sizes of x- and y-Vector. I'm going to skip these data.");
-    msgBox.exec();
   }
+  c.data->append(xVal, yVal);
+  c.rows=rows;
+}
+
+void PlotWindow::refreshDataSets() {
+  for (auto &c : curves)
+    readNewRows(c);
+  plot->setAxisAutoScale(QwtPlot::xBottom);
+  plot->setAxisAutoScale(QwtPlot::yLeft);
+  decimateCurves();
+  plot->replot();
+  zoom->setZoomBase();
 }
 
 void PlotWindow::replotPlot() {
@@ -177,11 +308,29 @@ void PlotWindow::replotPlot() {
     grid->attach(plot);
   }
 
+  decimateCurves();
   plot->replot();
   //zoom->setZoomBase(QwtDoubleRect(xMinValue, yMaxValue, xMaxValue-xMinValue, yMaxValue-yMinValue));
   zoom->setZoomBase();
 }
 
+void PlotWindow::decimateCurves() {
+  // update the (autoscaled) axes to get the visible x range without drawing all points
+  plot->updateAxes();
+  const QwtScaleDiv &xScale=plot->axisScaleDiv(QwtPlot::xBottom);
+  const int pixels=std::max(plot->canvas()->width(), 1);
+  for (auto &c : curves) {
+    c.data->decimate(std::min(xScale.lowerBound(), xScale.upperBound()), std::max(xScale.lowerBound(), xScale.upperBound()), pixels);
+    c.curve->itemChanged();
+  }
+}
+
+void PlotWindow::resizeEvent(QResizeEvent *event) {
+  QMdiSubWindow::resizeEvent(event);
+  decimateCurves();
+  plot->replot();
+}
+
 void PlotWindow::closeEvent(QCloseEvent *) {
   Curves * c = (static_cast<MainWindow*>(parent()->parent()->parent()))->getCurves();
   auto * pd=c->findChild<PlotDataTable*>(windowTitle());
@@ -24,13 +24,17 @@
 #include <QMdiSubWindow>
 #include "qvector.h"
 #include "qpen.h"
+#include "plotdata.h"
+#include <vector>
 
 class QCloseEvent;
+class QResizeEvent;
 
 class PlotWindow;
-class PlotData;
 class QwtPlot;
+class QwtPlotCurve;
 class QwtPlotZoomer;
+class CurveData;
 
 class PlotArea : public QMdiArea {
 
@@ -48,13 +52,28 @@ class PlotWindow : public QMdiSubWindow {
     void detachPlot();
     void plotDataSet(PlotData pd, int penColor);
     void replotPlot();
+    //! Append the rows written since the last plot/refresh to all curves and replot.
+    void refreshDataSets();
 
     void setPlotGrid(bool grid_=true) {plotGrid=grid_; }
 
   protected:
     void closeEvent(QCloseEvent * event) override;
+    void resizeEvent(QResizeEvent * event) override;
   
   private:
+    // a plotted curve and the number of rows of its datasets already read
+    struct Curve {
+      PlotData pd;
+      QwtPlotCurve * curve;
+      CurveData * data; // owned by curve
+      size_t rows{0};
+    };
+    std::vector<Curve> curves;
+    void readNewRows(Curve &c);
+    //! Decimate all curves to the visible x range and the canvas width.
+    void decimateCurves();
+
     QwtPlot * plot{0};
     QVector<QPen> pen;
     QwtPlotZoomer * zoom{0};
@@ -0,0 +1,569 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <hdf5serie/vectorserie.h>
+#include <hdf5serie/mappedvectorserie.h>
+#include <hdf5serie/rowcursor.h>
+#include <hdf5serie/simpledataset.h>
+#include <boost/lexical_cast.hpp>
+
+using namespace H5;
+using namespace std;
+
+// Benchmarks of the hdf5serie library.
+// This program is built by "make check" but not run as a test.
+// Usage: benchserie <benchmark> [<option>=<value> ...]
+
+namespace {
+
+map<string, string> para;
+
+template<class T>
+T getPara(const string &name, const T &def) {
+  auto it=para.find(name);
+  if(it==para.end())
+    return def;
+  return boost::lexical_cast<T>(it->second);
+}
+
+double timeIt(const function<void()> &func) {
+  auto start=chrono::steady_clock::now();
+  func();
+  return chrono::duration<double>(chrono::steady_clock::now()-start).count();
+}
+
+// number of write system calls of this process (Linux only, else 0)
+long writeSysCalls() {
+  long count=0;
+#ifdef __linux__
+  ifstream io("/proc/self/io");
+  string key;
+  long value;
+  while(io>>key>>value)
+    if(key=="syscw:")
+      count=value;
+#endif
+  return count;
+}
+
+void printResult(const string &name, double sec, const string &extra="") {
+  cout<<setw(40)<<left<<name<<setw(12)<<right<<fixed<<setprecision(4)<<sec<<" s"<<(extra.empty()?"":"  ")<<extra<<endl;
+}
+
+void writeSeries(const string &filename, const File::Options &opt, int nSeries, int rows, int cols) {
+  File file(filename, File::write, opt);
+  vector<VectorSerie<double>*> vs(nSeries);
+  for(int s=0; s<nSeries; ++s)
+    vs[s]=file.createChildObject<VectorSerie<double> >("serie"+to_string(s))(cols);
+  file.reopenAsSWMR();
+  vector<double> data(cols);
+  for(int r=0; r<rows; ++r) {
+    for(int s=0; s<nSeries; ++s) {
+      for(int c=0; c<cols; ++c)
+        data[c]=r*0.001+s+c;
+      vs[s]->append(data);
+    }
+    if(r%100==0)
+      file.flush();
+  }
+}
+
+void readAll(const string &filename, const File::Options &opt, int nSeries) {
+  File file(filename, File::read, opt);
+  for(int s=0; s<nSeries; ++s) {
+    auto *vs=file.openChildObject<VectorSerie<double> >("serie"+to_string(s));
+    vs->getColumn(0);
+  }
+}
+
+// compare the default file space handling with the paged aggregation presets
+void benchFileSpace() {
+  int nSeries=getPara<int>("series", 200);
+  int rows=getPara<int>("rows", 2000);
+  int cols=getPara<int>("cols", 10);
+  cout<<"filespace: "<<nSeries<<" series with "<<rows<<" rows and "<<cols<<" columns"<<endl;
+
+  vector<pair<string, File::Options>> cases {
+    { "default", File::Options() },
+    { "appendHeavyTimeSeries", File::Options::appendHeavyTimeSeries() },
+  };
+  for(auto &c : cases) {
+    string filename="benchfilespace_"+c.first+".h5";
+    long syscw=writeSysCalls();
+    double w=timeIt([&](){ writeSeries(filename, c.second, nSeries, rows, cols); });
+    syscw=writeSysCalls()-syscw;
+    printResult("write "+c.first, w, to_string(boost::filesystem::file_size(filename))+" bytes, "+
+                                     to_string(syscw)+" write calls");
+    double r=timeIt([&](){ readAll(filename, c.second, nSeries); });
+    printResult("read "+c.first, r);
+  }
+}
+
+// compare the open time of a reader for files with many series written with and without a metadata cache image
+void benchMetadataCacheImage() {
+  int nSeries=getPara<int>("series", 2000);
+  int rows=getPara<int>("rows", 10);
+  int cols=getPara<int>("cols", 10);
+  size_t mdcSize=getPara<size_t>("mdcsize", 32*1024*1024);
+  cout<<"mdcimage: "<<nSeries<<" series with "<<rows<<" rows and "<<cols<<" columns"<<endl;
+
+  File::Options noImage;
+  noImage.metadataCacheSize=mdcSize;
+  File::Options image=noImage;
+  image.metadataCacheImage=true;
+  vector<pair<string, File::Options>> cases {
+    { "default", File::Options() },
+    { "mdcsize", noImage },
+    { "mdcsize+image", image },
+  };
+  for(auto &c : cases) {
+    string filename="benchmdcimage_"+c.first+".h5";
+    double w=timeIt([&](){ writeSeries(filename, c.second, nSeries, rows, cols); });
+    printResult("write "+c.first, w);
+    File::Options readOpt;
+    readOpt.metadataCacheSize=c.second.metadataCacheSize;
+    double r=timeIt([&](){
+      File file(filename, File::read, readOpt);
+      for(auto &name : file.getChildObjectNames())
+        file.openChildObject<VectorSerie<double> >(name)->getRows();
+    });
+    printResult("open all series "+c.first, r);
+  }
+}
+
+// compare reading all rows of a uncompressed serie using getRow and using a MappedVectorSerie
+void benchMapped() {
+  int rows=getPara<int>("rows", 200000);
+  int cols=getPara<int>("cols", 50);
+  cout<<"mapped: "<<rows<<" rows and "<<cols<<" columns"<<endl;
+
+  string filename="benchmapped.h5";
+  {
+    File file(filename, File::write);
+    auto *vs=file.createChildObject<VectorSerie<double> >("serie")(cols, 0, 1000);
+    vector<double> data(cols);
+    for(int r=0; r<rows; ++r) {
+      for(int c=0; c<cols; ++c)
+        data[c]=r+c;
+      vs->append(data);
+    }
+  }
+  File file(filename, File::read);
+  auto *vs=file.openChildObject<VectorSerie<double> >("serie");
+  double sum1=0, sum2=0;
+  double t=timeIt([&](){
+    vector<double> data(cols);
+    for(int r=0; r<rows; ++r) {
+      vs->getRow(r, data);
+      sum1+=data[cols-1];
+    }
+  });
+  printResult("getRow", t);
+  t=timeIt([&](){
+    MappedVectorSerie<double> mvs(vs);
+    for(int r=0; r<rows; ++r)
+      sum2+=mvs.getRow(r)[cols-1];
+  });
+  printResult("MappedVectorSerie::getRow", t, sum1==sum2 ? "" : "RESULT DIFFERS");
+}
+
+// compare appending to a compressed serie using the HDF5 filter pipeline and using direct chunk write
+void benchDirectChunk() {
+  int rows=getPara<int>("rows", 200000);
+  int cols=getPara<int>("cols", 50);
+  int compression=getPara<int>("compression", 1);
+  int threads=getPara<int>("threads", File::getNumberOfWorkerThreads());
+  cout<<"directchunk: "<<rows<<" rows and "<<cols<<" columns, compression "<<compression<<", "<<threads<<" threads"<<endl;
+  File::setNumberOfWorkerThreads(threads);
+
+  for(bool direct : { false, true }) {
+    string name=direct ? "direct" : "pipeline";
+    string filename="benchdirectchunk_"+name+".h5";
+    double t=timeIt([&](){
+      File file(filename, File::write);
+      auto *vs=file.createChildObject<VectorSerie<double> >("serie")(cols, compression, 1000);
+      if(direct)
+        vs->enableDirectChunkWrite();
+      vector<double> data(cols);
+      for(int r=0; r<rows; ++r) {
+        for(int c=0; c<cols; ++c)
+          data[c]=r*0.001+c;
+        vs->append(data);
+      }
+    });
+    printResult("append "+name, t, to_string(boost::filesystem::file_size(filename))+" bytes");
+  }
+}
+
+// read a compressed serie with different numbers of worker threads (1 thread = serial read by the HDF5 filter pipeline)
+void benchParallelRead() {
+  int rows=getPara<int>("rows", 1000000);
+  int cols=getPara<int>("cols", 50);
+  int compression=getPara<int>("compression", 1);
+  string threadList=getPara<string>("threads", "1,2,4,8,16,32");
+  string filename=getPara<string>("file", "benchparallelread.h5");
+  cout<<"parallelread: "<<rows<<" rows and "<<cols<<" columns, compression "<<compression<<endl;
+
+  if(!boost::filesystem::exists(filename) || getPara<int>("write", 1)) {
+    File::setNumberOfWorkerThreads(thread::hardware_concurrency());
+    File file(filename, File::write);
+    auto *vs=file.createChildObject<VectorSerie<double> >("serie")(cols, compression, 1000);
+    vs->enableDirectChunkWrite();
+    vector<double> data(cols);
+    for(int r=0; r<rows; ++r) {
+      for(int c=0; c<cols; ++c)
+        data[c]=r*0.001+c;
+      vs->append(data);
+    }
+  }
+  cout<<"file size: "<<boost::filesystem::file_size(filename)<<" bytes"<<endl;
+
+  istringstream str(threadList);
+  string t;
+  while(getline(str, t, ',')) {
+    File::setNumberOfWorkerThreads(boost::lexical_cast<int>(t));
+    File file(filename, File::read);
+    auto *vs=file.openChildObject<VectorSerie<double> >("serie");
+    double sum=0;
+    double sec=timeIt([&](){ sum+=vs->getColumn(cols-1).back(); });
+    printResult("getColumn, "+t+" threads", sec);
+    vector<double> data(static_cast<size_t>(rows)*cols);
+    sec=timeIt([&](){ vs->getRowRange(0, rows, data.size(), data.data()); });
+    printResult("getRowRange (all rows), "+t+" threads", sec, data.back()==sum ? "" : "RESULT DIFFERS");
+  }
+}
+
+// iterate over all rows of a compressed serie using getRow and using a RowCursor with different read-ahead depths
+void benchRowCursor() {
+  int rows=getPara<int>("rows", 1000000);
+  int cols=getPara<int>("cols", 50);
+  int compression=getPara<int>("compression", 1);
+  string readAheadList=getPara<string>("readahead", "0,1,2,4");
+  cout<<"rowcursor: "<<rows<<" rows and "<<cols<<" columns, compression "<<compression<<endl;
+
+  string filename="benchrowcursor.h5";
+  {
+    File file(filename, File::write);
+    auto *vs=file.createChildObject<VectorSerie<double> >("serie")(cols, compression, 1000);
+    vs->enableDirectChunkWrite();
+    vector<double> data(cols);
+    for(int r=0; r<rows; ++r) {
+      for(int c=0; c<cols; ++c)
+        data[c]=r*0.001+c;
+      vs->append(data);
+    }
+  }
+  File file(filename, File::read);
+  auto *vs=file.openChildObject<VectorSerie<double> >("serie");
+  double sum1=0;
+  double sec=timeIt([&](){
+    vector<double> data(cols);
+    for(int r=0; r<rows; ++r) {
+      vs->getRow(r, data);
+      sum1+=data[cols-1];
+    }
+  });
+  printResult("getRow", sec);
+  istringstream str(readAheadList);
+  string ra;
+  while(getline(str, ra, ',')) {
+    double sum2=0;
+    RowCursor<double>::Stats stats;
+    sec=timeIt([&](){
+      RowCursor<double> cursor(vs, boost::lexical_cast<int>(ra));
+      while(cursor.next())
+        sum2+=cursor.getRow()[cols-1];
+      stats=cursor.getStats();
+    });
+    printResult("RowCursor, read-ahead "+ra, sec, to_string(stats.stalls)+"/"+to_string(stats.chunks)+" stalls, "+
+                to_string(stats.stallTime)+" s stall time"+(sum1==sum2 ? "" : ", RESULT DIFFERS"));
+  }
+}
+
+// compute a overview envelope of a column with and without a pyramid
+void benchPyramid() {
+  int rows=getPara<int>("rows", 5000000);
+  int cols=getPara<int>("cols", 10);
+  int points=getPara<int>("points", 2000);
+  cout<<"pyramid: "<<rows<<" rows and "<<cols<<" columns, "<<points<<" points"<<endl;
+
+  for(bool withPyramid : { false, true }) {
+    string name=withPyramid ? "pyramid" : "nopyramid";
+    string filename="benchpyramid_"+name+".h5";
+    double sec=timeIt([&](){
+      File file(filename, File::write);
+      auto *vs=file.createChildObject<VectorSerie<double> >("serie")(cols, 1, 1000);
+      if(withPyramid)
+        vs->enablePyramid();
+      vector<double> data(cols);
+      for(int r=0; r<rows; ++r) {
+        for(int c=0; c<cols; ++c)
+          data[c]=sin(r*0.0001*(c+1));
+        vs->append(data);
+      }
+    });
+    printResult("write "+name, sec, to_string(boost::filesystem::file_size(filename))+" bytes");
+    File file(filename, File::read);
+    auto *vs=file.openChildObject<VectorSerie<double> >("serie");
+    sec=timeIt([&](){ vs->getEnvelope(cols-1, 0, rows, points); });
+    printResult("envelope of all rows "+name, sec);
+    sec=timeIt([&](){ vs->getEnvelope(cols-1, rows/3, rows/3+rows/100, points); });
+    printResult("envelope of 1% of the rows "+name, sec);
+  }
+}
+
+// find the rows of a time range by reading the time column, by a binary search and by a time index
+void benchTimeIndex() {
+  int rows=getPara<int>("rows", 5000000);
+  int cols=getPara<int>("cols", 10);
+  int queries=getPara<int>("queries", 100);
+  cout<<"timeindex: "<<rows<<" rows and "<<cols<<" columns, "<<queries<<" queries"<<endl;
+
+  string filename="benchtimeindex.h5";
+  {
+    File file(filename, File::write);
+    auto *vs=file.createChildObject<VectorSerie<double> >("serie")(cols, 1, 1000);
+    auto *vsi=file.createChildObject<VectorSerie<double> >("serieindex")(cols, 1, 1000);
+    vsi->enableTimeIndex();
+    vector<double> data(cols);
+    for(int r=0; r<rows; ++r) {
+      for(int c=0; c<cols; ++c)
+        data[c]=r*0.001+c;
+      vs->append(data);
+      vsi->append(data);
+    }
+  }
+  File file(filename, File::read);
+  auto *vs=file.openChildObject<VectorSerie<double> >("serie");
+  auto *vsi=file.openChildObject<VectorSerie<double> >("serieindex");
+  double tEnd=rows*0.001;
+  auto tBegin=[&](int q) { return tEnd*q/queries; };
+  pair<int, int> r1, r2, r3;
+  double sec=timeIt([&](){
+    for(int q=0; q<queries; ++q) {
+      vector<double> t=vs->getColumn(0);
+      r1.first=lower_bound(t.begin(), t.end(), tBegin(q))-t.begin();
+      r1.second=upper_bound(t.begin(), t.end(), tBegin(q)+1)-t.begin();
+    }
+  });
+  printResult("getColumn", sec);
+  sec=timeIt([&](){
+    for(int q=0; q<queries; ++q)
+      r2=vs->findRowRange(tBegin(q), tBegin(q)+1);
+  });
+  printResult("findRowRange (binary search)", sec, r1==r2 ? "" : "RESULT DIFFERS");
+  sec=timeIt([&](){
+    for(int q=0; q<queries; ++q)
+      r3=vsi->findRowRange(tBegin(q), tBegin(q)+1);
+  });
+  printResult("findRowRange (time index)", sec, r1==r3 ? "" : "RESULT DIFFERS");
+}
+
+// find the rows with a value above a threshold (a rare event) with and without a zone map
+void benchZoneMap() {
+  int rows=getPara<int>("rows", 2000000);
+  int cols=getPara<int>("cols", 20);
+  cout<<"zonemap: "<<rows<<" rows and "<<cols<<" columns"<<endl;
+
+  string filename="benchzonemap.h5";
+  {
+    File file(filename, File::write);
+    auto *vs=file.createChildObject<VectorSerie<double> >("serie")(cols, 1, 1000);
+    auto *vsz=file.createChildObject<VectorSerie<double> >("seriezonemap")(cols, 1, 1000);
+    vsz->enableZoneMap();
+    vector<double> data(cols);
+    for(int r=0; r<rows; ++r) {
+      for(int c=0; c<cols; ++c)
+        data[c]=sin(r*0.001*(c+1))+(r%(rows/10)==7 ? 10 : 0); // 10 events
+      vs->append(data);
+      vsz->append(data);
+    }
+  }
+  File file(filename, File::read);
+  for(string name : { "serie", "seriezonemap" }) {
+    auto *vs=file.openChildObject<VectorSerie<double> >(name);
+    size_t chunksRead;
+    vector<int> found;
+    double sec=timeIt([&](){ found=vs->findRows(cols/2, 5, numeric_limits<double>::infinity(), &chunksRead); });
+    printResult("findRows "+name, sec, to_string(found.size())+" rows found, "+to_string(chunksRead)+" chunks read");
+  }
+}
+
+// compare appending and reading a column of a wide serie in row layout and in column layout
+void benchLayout() {
+  int rows=getPara<int>("rows", 20000);
+  int cols=getPara<int>("cols", 2000);
+  string columnsPerChunkList=getPara<string>("columnsperchunk", "0,256,64,16");
+  cout<<"layout: "<<rows<<" rows and "<<cols<<" columns"<<endl;
+
+  istringstream str(columnsPerChunkList);
+  string cpc;
+  while(getline(str, cpc, ',')) {
+    string filename="benchlayout_"+cpc+".h5";
+    double sec=timeIt([&](){
+      File file(filename, File::write);
+      auto *vs=file.createChildObject<VectorSerie<double> >("serie")(cols, 1, 100, boost::lexical_cast<int>(cpc));
+      vector<double> data(cols);
+      for(int r=0; r<rows; ++r) {
+        for(int c=0; c<cols; ++c)
+          data[c]=sin(r*0.001*(c+1));
+        vs->append(data);
+      }
+    });
+    string name=cpc=="0" ? "row layout" : to_string(boost::lexical_cast<int>(cpc))+" columns per chunk";
+    printResult("append, "+name, sec, to_string(boost::filesystem::file_size(filename))+" bytes");
+    File file(filename, File::read);
+    auto *vs=file.openChildObject<VectorSerie<double> >("serie");
+    sec=timeIt([&](){ vs->getColumn(cols/2); });
+    printResult("getColumn, "+name, sec);
+    sec=timeIt([&](){
+      vector<double> data(cols);
+      for(int r=0; r<rows; r+=rows/100)
+        vs->getRow(r, data);
+    });
+    printResult("100 x getRow, "+name, sec);
+  }
+}
+
+// compare the file size and the read time of plain deflate and the predictive filter followed by deflate
+void benchPredict() {
+  int rows=getPara<int>("rows", 500000);
+  int cols=getPara<int>("cols", 20);
+  int compression=getPara<int>("compression", 1);
+  cout<<"predict: "<<rows<<" rows and "<<cols<<" columns (time and smooth signals), compression "<<compression<<endl;
+
+  for(bool predict : { false, true }) {
+    string name=predict ? "predictive filter + deflate" : "deflate";
+    string filename=string("benchpredict_")+(predict ? "predict" : "deflate")+".h5";
+    VectorSerieOptions opt(compression, 1000);
+    opt.predictiveFilter=predict;
+    double sec=timeIt([&](){
+      File file(filename, File::write);
+      auto *vs=file.createChildObject<VectorSerie<double> >("serie")(cols, opt);
+      vector<double> data(cols);
+      for(int r=0; r<rows; ++r) {
+        data[0]=r*1e-4;
+        for(int c=1; c<cols; ++c)
+          data[c]=sin(data[0]*c)*exp(-data[0]*0.01);
+        vs->append(data);
+      }
+    });
+    printResult("write, "+name, sec, to_string(boost::filesystem::file_size(filename))+" bytes");
+    File file(filename, File::read);
+    auto *vs=file.openChildObject<VectorSerie<double> >("serie");
+    sec=timeIt([&](){
+      vector<double> data(static_cast<size_t>(rows)*cols);
+      vs->getRowRange(0, rows, data.size(), data.data());
+    });
+    printResult("read, "+name, sec);
+  }
+}
+
+// compare the file size of lossless and lossy (relative error bound, about 6 significant digits) storage
+void benchLossy() {
+  int rows=getPara<int>("rows", 500000);
+  int cols=getPara<int>("cols", 20);
+  int compression=getPara<int>("compression", 1);
+  double relativeError=getPara<double>("relerr", 1e-6);
+  cout<<"lossy: "<<rows<<" rows and "<<cols<<" columns (time and smooth signals), compression "<<compression<<
+        ", relative error "<<relativeError<<endl;
+
+  for(int mode=0; mode<4; ++mode) {
+    bool lossy=mode%2==1, predict=mode>=2;
+    string name=string(lossy ? "lossy" : "lossless")+(predict ? " + predictive filter" : "");
+    string filename="benchlossy_"+to_string(mode)+".h5";
+    VectorSerieOptions opt(compression, 1000);
+    opt.predictiveFilter=predict;
+    opt.relativeError=lossy ? relativeError : 0;
+    double sec=timeIt([&](){
+      File file(filename, File::write);
+      auto *vs=file.createChildObject<VectorSerie<double> >("serie")(cols, opt);
+      vector<double> data(cols);
+      for(int r=0; r<rows; ++r) {
+        data[0]=r*1e-4;
+        for(int c=1; c<cols; ++c)
+          data[c]=sin(data[0]*c)*exp(-data[0]*0.01);
+        vs->append(data);
+      }
+    });
+    printResult("write, "+name, sec, to_string(boost::filesystem::file_size(filename))+" bytes");
+    File file(filename, File::read);
+    auto *vs=file.openChildObject<VectorSerie<double> >("serie");
+    sec=timeIt([&](){
+      vector<double> data(static_cast<size_t>(rows)*cols);
+      vs->getRowRange(0, rows, data.size(), data.data());
+    });
+    printResult("read, "+name, sec);
+  }
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  map<string, function<void()>> bench {
+    { "filespace", &benchFileSpace },
+    { "mdcimage", &benchMetadataCacheImage },
+    { "mapped", &benchMapped },
+    { "directchunk", &benchDirectChunk },
+    { "parallelread", &benchParallelRead },
+    { "rowcursor", &benchRowCursor },
+    { "pyramid", &benchPyramid },
+    { "timeindex", &benchTimeIndex },
+    { "zonemap", &benchZoneMap },
+    { "layout", &benchLayout },
+    { "predict", &benchPredict },
+    { "lossy", &benchLossy },
+  };
+
+  if(argc<2 || bench.find(argv[1])==bench.end()) {
+    cout<<"Usage: "<<argv[0]<<" <benchmark> [<option>=<value> ...]"<<endl;
+    cout<<"Benchmarks:"<<endl;
+    for(auto &b : bench)
+      cout<<"  "<<b.first<<endl;
+    return argc<2 ? 0 : 1;
+  }
+  for(int i=2; i<argc; ++i) {
+    string a=argv[i];
+    size_t pos=a.find('=');
+    para[a.substr(0, pos)]=pos==string::npos ? "" : a.substr(pos+1);
+  }
+
+  try {
+    bench[argv[1]]();
+  }
+  catch(const std::exception &ex) {
+    cout<<ex.what()<<endl;
+    return 1;
+  }
+  return 0;
+}
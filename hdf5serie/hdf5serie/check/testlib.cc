@@ -23,10 +23,15 @@
 #include <cassert>
 #include <cfenv>
 #include <hdf5serie/vectorserie.h>
+#include <hdf5serie/mappedvectorserie.h>
+#include <hdf5serie/rowcursor.h>
 //#include <hdf5serie/matrixserie.h>
 //#include <hdf5serie/structserie.h>
 #include <hdf5serie/simpleattribute.h>
 #include <hdf5serie/simpledataset.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <iostream>
 #include <fmatvec/fmatvec.h>
 
@@ -312,6 +317,551 @@ int main() {
   }
 
 
+  /***** in-memory file *****/
+  cout<<"IN-MEMORY FILE\n";
+  {
+  File::Options opt;
+  opt.inMemory=true;
+  File file("testmem.h5", File::write, opt);
+  VectorSerie<double> *ts=file.createChildObject<VectorSerie<double> >("timeserie")(2);
+  vector<double> data(2);
+  for(int i=0; i<250; ++i) {
+    data[0]=i; data[1]=2*i;
+    ts->append(data);
+  }
+  SimpleDataset<string> *dsd=file.createChildObject<SimpleDataset<string> >("dsd")();
+  dsd->write("inmemory");
+  file.flush();
+  file.reopenAsSWMR();
+  }
+  {
+  File file("testmem.h5", File::read);
+  VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >("timeserie");
+  cout<<ts->getRows()<<endl;
+  if(ts->getRows()!=250)
+    throw runtime_error("In-memory file has "+to_string(ts->getRows())+" rows instead of 250.");
+  vector<double> out=ts->getRow(249);
+  for(unsigned int i=0; i<out.size(); i++) cout<<out[i]<<endl;
+  if(out!=vector<double>{249, 498})
+    throw runtime_error("Last row of in-memory file differs.");
+  string dsdValue=file.openChildObject<SimpleDataset<string> >("dsd")->read();
+  cout<<dsdValue<<endl;
+  if(dsdValue!="inmemory")
+    throw runtime_error("SimpleDataset of in-memory file differs.");
+  }
+
+  /***** paged aggregation *****/
+  cout<<"PAGED AGGREGATION\n";
+  {
+  File file("testpaged.h5", File::write, File::Options::appendHeavyTimeSeries());
+  VectorSerie<double> *ts=file.createChildObject<VectorSerie<double> >("timeserie")(2);
+  file.reopenAsSWMR();
+  vector<double> data(2);
+  for(int i=0; i<250; ++i) {
+    data[0]=i; data[1]=2*i;
+    ts->append(data);
+  }
+  }
+  {
+  File file("testpaged.h5", File::read, File::Options::appendHeavyTimeSeries());
+  VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >("timeserie");
+  cout<<ts->getRows()<<endl;
+  if(ts->getRows()!=250)
+    throw runtime_error("Paged aggregation file has "+to_string(ts->getRows())+" rows instead of 250.");
+  vector<double> out=ts->getRow(249);
+  for(unsigned int i=0; i<out.size(); i++) cout<<out[i]<<endl;
+  if(out!=vector<double>{249, 498})
+    throw runtime_error("Last row of paged aggregation file differs.");
+  }
+
+  /***** metadata cache image *****/
+  cout<<"METADATA CACHE IMAGE\n";
+  {
+  File::Options opt;
+  opt.metadataCacheSize=4*1024*1024;
+  opt.metadataCacheImage=true;
+  File file("testmdc.h5", File::write, opt);
+  for(int i=0; i<10; ++i)
+    file.createChildObject<VectorSerie<double> >("timeserie"+to_string(i))(2);
+  file.reopenAsSWMR();
+  vector<double> data(2, 1.5);
+  file.openChildObject<VectorSerie<double> >("timeserie9")->append(data);
+  }
+  {
+  File::Options opt;
+  opt.metadataCacheSize=4*1024*1024;
+  File file("testmdc.h5", File::read, opt);
+  cout<<file.getChildObjectNames().size()<<endl;
+  if(file.getChildObjectNames().size()!=10)
+    throw runtime_error("Metadata cache image file has not 10 datasets.");
+  VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >("timeserie9");
+  cout<<ts->getRows()<<endl;
+  if(ts->getRows()!=1 || ts->getRow(0)!=vector<double>{1.5, 1.5})
+    throw runtime_error("Row appended in SWMR mode to the metadata cache image file differs.");
+  }
+
+  /***** memory mapped vectorserie *****/
+  cout<<"MAPPED VECTORSERIE\n";
+  {
+  File file("testmapped.h5", File::write);
+  VectorSerie<double> *ts=file.createChildObject<VectorSerie<double> >("timeserie")(3, 0, 10);
+  file.reopenAsSWMR();
+  vector<double> data(3);
+  for(int i=0; i<25; ++i) {
+    data[0]=i; data[1]=2*i; data[2]=3*i;
+    ts->append(data);
+  }
+  }
+  {
+  File file("testmapped.h5", File::read);
+  VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >("timeserie");
+  MappedVectorSerie<double> mts(ts);
+  cout<<mts.getRows()<<" "<<mts.getNumberOfChunks()<<" "<<mts.getChunk(2).size()<<endl;
+  for(size_t r=0; r<mts.getRows(); ++r) {
+    vector<double> row=ts->getRow(r);
+    Span<const double> mrow=mts.getRow(r);
+    if(!equal(row.begin(), row.end(), mrow.begin(), mrow.end()))
+      throw runtime_error("Memory mapped row "+to_string(r)+" differs.");
+  }
+  for(double v : mts.getRow(24)) cout<<v<<endl;
+  }
+
+  /***** direct chunk write *****/
+  cout<<"DIRECT CHUNK WRITE\n";
+  int threadsDirect=File::getNumberOfWorkerThreads();
+  File::setNumberOfWorkerThreads(0); // handled as 1: the direct chunk write must not wait for a missing worker
+  if(File::getNumberOfWorkerThreads()!=1)
+    throw runtime_error("The number of worker threads must be at least 1.");
+  {
+  File file("testdirect.h5", File::write);
+  VectorSerie<double> *ts=file.createChildObject<VectorSerie<double> >("timeserie")(3, 1, 10);
+  ts->enableDirectChunkWrite();
+  file.reopenAsSWMR();
+  vector<double> data(3);
+  for(int i=0; i<95; ++i) {
+    data[0]=i; data[1]=2*i; data[2]=3*i;
+    ts->append(data);
+    if(i==33)
+      file.flush();
+  }
+  cout<<ts->getRows()<<endl;
+  }
+  {
+  File file("testdirect.h5", File::read);
+  VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >("timeserie");
+  cout<<ts->getRows()<<endl;
+  for(int i=0; i<ts->getRows(); ++i) {
+    vector<double> row=ts->getRow(i);
+    if(row[0]!=i || row[1]!=2*i || row[2]!=3*i)
+      throw runtime_error("Row "+to_string(i)+" written by direct chunk write differs.");
+  }
+  vector<double> out=ts->getColumn(2);
+  cout<<out[94]<<endl;
+  }
+  File::setNumberOfWorkerThreads(threadsDirect);
+
+  /***** parallel read *****/
+  cout<<"PARALLEL READ\n";
+  {
+  int threads=File::getNumberOfWorkerThreads();
+  File::setNumberOfWorkerThreads(4);
+  {
+  File file("testparallel.h5", File::write);
+  VectorSerie<double> *ts=file.createChildObject<VectorSerie<double> >("timeserie")(3, 1, 10);
+  vector<double> data(3);
+  for(int i=0; i<95; ++i) {
+    data[0]=i; data[1]=2*i; data[2]=3*i;
+    ts->append(data);
+  }
+  }
+  {
+  File file("testparallel.h5", File::read);
+  VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >("timeserie");
+  vector<double> col=ts->getColumn(1);
+  for(int i=0; i<95; ++i)
+    if(col[i]!=2*i)
+      throw runtime_error("Column element "+to_string(i)+" read in parallel differs.");
+  vector<double> rows(3*41);
+  ts->getRowRange(7, 41, rows.size(), rows.data());
+  for(int i=0; i<41; ++i)
+    if(rows[3*i]!=7+i || rows[3*i+2]!=3*(7+i))
+      throw runtime_error("Row "+to_string(7+i)+" read in parallel differs.");
+  cout<<col[94]<<" "<<rows[3*40+1]<<endl;
+  // selected columns (in any order) of every 4th row
+  vector<double> sel(3*12);
+  ts->getRowRange(3, 12, {2, 0, 2}, sel.size(), sel.data(), 4);
+  for(int i=0; i<12; ++i)
+    if(sel[3*i]!=3*(3+4*i) || sel[3*i+1]!=3+4*i || sel[3*i+2]!=3*(3+4*i))
+      throw runtime_error("Row "+to_string(3+4*i)+" of the selected columns differs.");
+  cout<<sel[3*11+1]<<endl;
+  }
+  File::setNumberOfWorkerThreads(threads);
+  }
+
+  /***** row cursor *****/
+  cout<<"ROW CURSOR\n";
+  {
+  File file("testparallel.h5", File::read);
+  VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >("timeserie");
+  RowCursor<double> cursor(ts, 3, 5, 93);
+  int n=0;
+  while(cursor.next()) {
+    Span<const double> row=cursor.getRow();
+    int i=cursor.getRowNumber();
+    if(i!=5+n || row.size()!=3 || row[0]!=i || row[2]!=3*i)
+      throw runtime_error("Row "+to_string(i)+" read by the cursor differs.");
+    n++;
+  }
+  cout<<n<<" "<<cursor.getStats().chunks<<endl;
+  // without read-ahead
+  RowCursor<double> cursor0(ts, -1, 90);
+  n=0;
+  while(cursor0.next())
+    n++;
+  if(n!=ts->getRows()-90)
+    throw runtime_error("The cursor without read-ahead read "+to_string(n)+" rows.");
+  bool thrown=false;
+  try { RowCursor<double> cursorInvalid(ts, 2, -1); }
+  catch(const Exception &) { thrown=true; }
+  if(!thrown)
+    throw runtime_error("A cursor with a negative start row was accepted.");
+  }
+
+  /***** pyramid *****/
+  cout<<"PYRAMID\n";
+  {
+  File file("testpyramid.h5", File::write);
+  VectorSerie<double> *ts=file.createChildObject<VectorSerie<double> >("timeserie")(2, 1, 10);
+  vector<double> data(2);
+  for(int i=0; i<100; ++i) {
+    data[0]=i; data[1]=sin(i*0.1);
+    ts->append(data);
+  }
+  ts->enablePyramid(4, 3);
+  file.reopenAsSWMR();
+  for(int i=100; i<1001; ++i) {
+    data[0]=i; data[1]=sin(i*0.1);
+    ts->append(data);
+  }
+  }
+  {
+  File file("testpyramid.h5", File::read);
+  if(file.getChildObjectNames().size()!=1)
+    throw runtime_error("The pyramid datasets must not be listed as child objects.");
+  VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >("timeserie");
+  for(int c=0; c<2; ++c) {
+  vector<double> col=ts->getColumn(c);
+  for(auto range : vector<array<int, 3>>{{0, 1001, 10}, {37, 913, 7}, {5, 9, 10}, {100, 999, 1}}) {
+    Envelope env=ts->getEnvelope(c, range[0], range[1], range[2]);
+    for(size_t b=0; b<env.min.size(); ++b) {
+      double mn=numeric_limits<double>::infinity(), mx=-mn, mean=0;
+      for(hsize_t r=env.firstRow[b]; r<env.firstRow[b]+env.rows[b]; ++r) {
+        mn=min(mn, col[r]);
+        mx=max(mx, col[r]);
+        mean+=col[r]/env.rows[b];
+      }
+      if(env.min[b]!=mn || env.max[b]!=mx || fabs(env.mean[b]-mean)>1e-9*(1+fabs(mean)))
+        throw runtime_error("Envelope of bin "+to_string(b)+" of column "+to_string(c)+" differs.");
+    }
+    cout<<env.min.size()<<" "<<env.rows[0]<<endl;
+  }
+  }
+  }
+
+  /***** time index *****/
+  cout<<"TIME INDEX\n";
+  {
+  File file("testtimeindex.h5", File::write);
+  VectorSerie<double> *ts=file.createChildObject<VectorSerie<double> >("timeserie")(2, 1, 10);
+  VectorSerie<double> *ts2=file.createChildObject<VectorSerie<double> >("timeserie2")(2, 1, 10);
+  vector<double> data(2);
+  for(int i=0; i<25; ++i) {
+    data[0]=i*0.5; data[1]=i;
+    ts->append(data);
+    ts2->append(data);
+  }
+  ts->enableTimeIndex();
+  file.reopenAsSWMR();
+  for(int i=25; i<1003; ++i) {
+    data[0]=i*0.5; data[1]=i;
+    if(i>=500 && i<510) data[0]=250; // equal time values
+    ts->append(data);
+    ts2->append(data);
+    if(i==249) {
+      // a flush writes the buffered index entries of a incomplete chunk of the index dataset for SWMR readers
+      file.flush();
+      File reader("testtimeindex.h5", File::read);
+      ScopedHID index(H5Dopen(reader.getID(), ".timeserie.timeindex", H5P_DEFAULT), &H5Dclose);
+      ScopedHID space(H5Dget_space(index), &H5Sclose);
+      hsize_t dims[2];
+      H5Sget_simple_extent_dims(space, dims, nullptr);
+      if(dims[0]!=25)
+        throw runtime_error("The flushed time index has "+to_string(dims[0])+" instead of 25 entries.");
+    }
+  }
+  }
+  {
+  File file("testtimeindex.h5", File::read);
+  VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >("timeserie");
+  VectorSerie<double> *ts2=file.openChildObject<VectorSerie<double> >("timeserie2");
+  if(!ts->hasTimeIndex() || ts2->hasTimeIndex())
+    throw runtime_error("Wrong time index.");
+  vector<double> t=ts->getColumn(0);
+  for(auto range : vector<pair<double, double>>{{-1, 1000}, {0, 0}, {3.2, 17.5}, {250, 250}, {249.9, 250.1}, {500, 501.5},
+                                                {495, 510}, {600, 500}, {-5, -1}}) {
+    auto expected=make_pair(lower_bound(t.begin(), t.end(), range.first)-t.begin(), upper_bound(t.begin(), t.end(), range.second)-t.begin());
+    expected.second=max(expected.first, expected.second);
+    auto r=ts->findRowRange(range.first, range.second);
+    auto r2=ts2->findRowRange(range.first, range.second);
+    if(r.first!=expected.first || r.second!=expected.second || r2!=r)
+      throw runtime_error("Wrong row range for time range ["+to_string(range.first)+", "+to_string(range.second)+"].");
+    cout<<r.first<<" "<<r.second<<endl;
+  }
+  bool thrown=false;
+  try { ts->findRowRange(NAN, 10); } catch(const exception &) { thrown=true; }
+  if(!thrown)
+    throw runtime_error("A NaN bound of a time range must throw.");
+  }
+
+  /***** zone map *****/
+  cout<<"ZONE MAP\n";
+  {
+  File file("testzonemap.h5", File::write);
+  VectorSerie<double> *ts=file.createChildObject<VectorSerie<double> >("timeserie")(3, 1, 10);
+  VectorSerie<double> *ts2=file.createChildObject<VectorSerie<double> >("timeserie2")(3, 1, 10);
+  file.createChildObject<VectorSerie<double> >(".user.zonemap")(1); // not a companion dataset: no object ".user"
+  vector<double> data(3);
+  for(int i=0; i<1005; ++i) {
+    if(i==15)
+      ts->enableZoneMap();
+    if(i==20)
+      file.reopenAsSWMR();
+    data[0]=i; data[1]=i<500 ? i%7 : (i<600 ? 100+i : 0); data[2]=i%97==3 ? numeric_limits<double>::quiet_NaN() : 1;
+    ts->append(data);
+    ts2->append(data);
+  }
+  }
+  {
+  File file("testzonemap.h5", File::read);
+  VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >("timeserie");
+  VectorSerie<double> *ts2=file.openChildObject<VectorSerie<double> >("timeserie2");
+  if(!ts->hasZoneMap() || ts2->hasZoneMap())
+    throw runtime_error("Wrong zone map.");
+  if(file.getChildObjectNames()!=set<string>{".user.zonemap", "timeserie", "timeserie2"})
+    throw runtime_error("Wrong child objects of a file with a companion dataset.");
+  vector<double> c1=ts->getColumn(1);
+  vector<int> expected;
+  for(int i=0; i<1005; ++i)
+    if(c1[i]>=650 && c1[i]<=1e9)
+      expected.push_back(i);
+  size_t chunksRead, chunksRead2;
+  vector<int> rows=ts->findRows(1, 650, numeric_limits<double>::infinity(), &chunksRead);
+  vector<int> rows2=ts2->findRows(1, 650, numeric_limits<double>::infinity(), &chunksRead2);
+  if(rows!=expected || rows2!=expected)
+    throw runtime_error("findRows returned wrong rows.");
+  cout<<rows.size()<<" "<<chunksRead<<" "<<chunksRead2<<endl;
+  rows=ts->findNaNRows(2, &chunksRead);
+  if(rows.size()!=11 || rows[0]!=3 || rows[10]!=973)
+    throw runtime_error("findNaNRows returned wrong rows.");
+  cout<<rows.size()<<" "<<chunksRead<<endl;
+  }
+
+  /***** column layout *****/
+  cout<<"COLUMN LAYOUT\n";
+  {
+  int threads=File::getNumberOfWorkerThreads();
+  {
+  File file("testcolumnlayout.h5", File::write);
+  VectorSerie<double> *ts=file.createChildObject<VectorSerie<double> >("timeserie")(7, 1, 10, 3);
+  file.reopenAsSWMR();
+  vector<double> data(7);
+  for(int i=0; i<95; ++i) {
+    for(int c=0; c<7; ++c)
+      data[c]=i*10+c;
+    ts->append(data);
+  }
+  }
+  for(int t : {1, 4}) {
+    File::setNumberOfWorkerThreads(t);
+    File file("testcolumnlayout.h5", File::read);
+    VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >("timeserie");
+    vector<double> row=ts->getRow(42);
+    for(int c=0; c<7; ++c)
+      if(row[c]!=420+c)
+        throw runtime_error("Row of a column layout dataset differs.");
+    for(int c=0; c<7; ++c) {
+      vector<double> col=ts->getColumn(c);
+      for(int i=0; i<95; ++i)
+        if(col[i]!=i*10+c)
+          throw runtime_error("Column of a column layout dataset differs.");
+    }
+    vector<double> rows(7*20);
+    ts->getRowRange(5, 20, rows.size(), rows.data());
+    if(rows[0]!=50 || rows[7*20-1]!=246)
+      throw runtime_error("Row range of a column layout dataset differs.");
+    cout<<row[6]<<" "<<rows[7*20-1]<<endl;
+  }
+  File::setNumberOfWorkerThreads(threads);
+  }
+
+  /***** predictive filter *****/
+  cout<<"PREDICTIVE FILTER\n";
+  {
+  int threads=File::getNumberOfWorkerThreads();
+  VectorSerieOptions opt(1, 10);
+  opt.predictiveFilter=true;
+  {
+  File file("testpredict.h5", File::write);
+  VectorSerie<double> *ts=file.createChildObject<VectorSerie<double> >("timeserie")(3, opt);
+  VectorSerie<double> *tsd=file.createChildObject<VectorSerie<double> >("direct")(3, opt);
+  tsd->enableDirectChunkWrite();
+  VectorSerie<short> *tsi=file.createChildObject<VectorSerie<short> >("short")(2, opt);
+  VectorSerieOptions optModes(opt);
+  optModes.predictModes={predictNone, predictDelta, predictXOR};
+  VectorSerie<double> *tsm=file.createChildObject<VectorSerie<double> >("modes")(3, optModes);
+  optModes.columnsPerChunk=2;
+  bool thrown=false;
+  try { file.createChildObject<VectorSerie<double> >("modesinvalid")(3, optModes); } catch(const Exception &) { thrown=true; }
+  if(!thrown)
+    throw runtime_error("Prediction modes not repeating with the columns per chunk must throw.");
+  file.reopenAsSWMR();
+  vector<double> data(3);
+  vector<short> datai(2);
+  for(int i=0; i<95; ++i) {
+    data[0]=i*1e-3; data[1]=sin(i*0.1); data[2]=-i*1e10;
+    ts->append(data);
+    tsd->append(data);
+    tsm->append(data);
+    datai[0]=i; datai[1]=-3*i;
+    tsi->append(datai);
+  }
+  }
+  for(int t : {1, 4}) {
+    File::setNumberOfWorkerThreads(t);
+    File file("testpredict.h5", File::read);
+    for(string name : {"timeserie", "direct", "modes"}) {
+      VectorSerie<double> *ts=file.openChildObject<VectorSerie<double> >(name);
+      vector<double> c0=ts->getColumn(0), c1=ts->getColumn(1), c2=ts->getColumn(2);
+      for(int i=0; i<95; ++i)
+        if(c0[i]!=i*1e-3 || c1[i]!=sin(i*0.1) || c2[i]!=-i*1e10)
+          throw runtime_error("Value "+to_string(i)+" of the predictive filter dataset "+name+" differs.");
+    }
+    VectorSerie<short> *tsi=file.openChildObject<VectorSerie<short> >("short");
+    vector<short> c1=tsi->getColumn(1);
+    for(int i=0; i<95; ++i)
+      if(c1[i]!=-3*i)
+        throw runtime_error("Value "+to_string(i)+" of the predictive filter short dataset differs.");
+    cout<<c1[94]<<endl;
+  }
+  File::setNumberOfWorkerThreads(threads);
+  }
+
+  /***** lossy storage *****/
+  cout<<"LOSSY STORAGE\n";
+  {
+  auto value=[](int i, int c) { return c==0 ? i*1e-3 : (c==1 ? 1e5*sin(i*0.1) : (i==7 ? NAN : -i*1e10)); };
+  VectorSerieOptions rel(1, 10), abs(1, 10), tiny(1, 10);
+  rel.relativeError=1e-6;
+  abs.absoluteError=1e-3;
+  tiny.absoluteError=1e-300; // v/step overflows for the large values
+  {
+  File file("testlossy.h5", File::write);
+  VectorSerie<double> *tsr=file.createChildObject<VectorSerie<double> >("relative")(3, rel);
+  VectorSerie<double> *tsa=file.createChildObject<VectorSerie<double> >("absolute")(3, abs);
+  VectorSerie<float> *tsf=file.createChildObject<VectorSerie<float> >("float")(3, rel);
+  VectorSerie<double> *tst=file.createChildObject<VectorSerie<double> >("tiny")(1, tiny);
+  tsr->enableZoneMap();
+  bool thrown=false;
+  try { file.createChildObject<VectorSerie<int> >("int")(3, rel); } catch(const exception &) { thrown=true; }
+  if(!thrown)
+    throw runtime_error("Lossy storage of a int dataset must throw.");
+  file.reopenAsSWMR();
+  vector<double> data(3);
+  vector<float> dataf(3);
+  for(int i=0; i<95; ++i) {
+    for(int c=0; c<3; ++c) {
+      data[c]=value(i, c);
+      dataf[c]=value(i, c);
+    }
+    tsr->append(data);
+    tsa->append(data);
+    tsf->append(dataf);
+    tst->append(vector<double>{i*1e306});
+  }
+  }
+  File file("testlossy.h5", File::read);
+  VectorSerie<double> *tsr=file.openChildObject<VectorSerie<double> >("relative");
+  VectorSerie<double> *tsa=file.openChildObject<VectorSerie<double> >("absolute");
+  VectorSerie<float> *tsf=file.openChildObject<VectorSerie<float> >("float");
+  VectorSerie<double> *tst=file.openChildObject<VectorSerie<double> >("tiny");
+  if(tsr->openChildAttribute<SimpleAttribute<double> >("Lossy Relative Error")->read()!=1e-6 ||
+     tsa->openChildAttribute<SimpleAttribute<double> >("Lossy Absolute Error")->read()!=1e-3)
+    throw runtime_error("The error bound attributes of the lossy storage are wrong.");
+  for(int i=0; i<95; ++i) {
+    vector<double> r=tsr->getRow(i), a=tsa->getRow(i);
+    vector<float> f=tsf->getRow(i);
+    for(int c=0; c<3; ++c) {
+      double v=value(i, c);
+      if(isnan(v) ? !isnan(r[c]) || !isnan(a[c]) || !isnan(f[c]) :
+         fabs(r[c]-v)>1e-6*fabs(v) || fabs(a[c]-v)>1e-3 || fabs(f[c]-static_cast<float>(v))>1e-6*fabs(v))
+        throw runtime_error("Value "+to_string(i)+", "+to_string(c)+" of the lossy storage exceeds the error bound.");
+    }
+    if(tst->getRow(i)[0]!=i*1e306)
+      throw runtime_error("Value "+to_string(i)+" of the lossy storage with a tiny error bound was changed.");
+  }
+  if(tsr->findNaNRows(2)!=vector<int>{7})
+    throw runtime_error("The NaN row of the lossy storage was not found.");
+  cout<<tsr->getRow(94)[1]<<" "<<tsa->getRow(94)[1]<<endl;
+  }
+
+  /***** writer flush client *****/
+  cout<<"WRITER FLUSH CLIENT\n";
+  {
+  File file("testflush.h5", File::write);
+  WriterFlushClient client("testflush.h5"), noWriter("testflushnotexisting.h5");
+  if(noWriter.requestFlush() || noWriter.waitForFlush(10)!=-1)
+    throw runtime_error("A flush request without a writer must fail.");
+  // the writer does not flush: the wait must time out
+  if(!client.requestFlush())
+    throw runtime_error("The flush request failed.");
+  auto start=chrono::steady_clock::now();
+  if(client.waitForFlush(50)!=-1)
+    throw runtime_error("The flush must time out.");
+  double waited=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+  if(waited<0.04 || waited>5)
+    throw runtime_error("The flush did not time out after 50 msec but after "+to_string(waited)+" sec.");
+  // the writer flushes
+  if(!client.requestFlush())
+    throw runtime_error("The flush request failed.");
+  file.flushIfRequested();
+  if(client.waitForFlush(1000)<0)
+    throw runtime_error("The flush was not detected.");
+  cout<<"flushed"<<endl;
+  }
+
+  /***** repack *****/
+  cout<<"REPACK\n";
+  { // a file with all kinds of objects, copied by h5repackserie and compared in testdump
+  File file("testrepack.h5", File::write);
+  VectorSerie<double> *ts=file.createChildObject<VectorSerie<double> >("timeserie")(3, VectorSerieOptions(1, 10));
+  ts->setColumnLabel({"t", "x", "y"});
+  ts->setDescription("repack source");
+  ts->enablePyramid(4, 2);
+  VectorSerie<int> *tsu=file.createChildObject<VectorSerie<int> >(".user")(2);
+  tsu->enableTimeIndex(1);
+  Group *grp=file.createChildObject<Group>("grp")();
+  auto *matrix=grp->createChildObject<SimpleDataset<vector<vector<double> > > >("matrix")(2, 3);
+  matrix->write({{1, 2, 3}, {4, 5, 6}});
+  matrix->setDescription("a matrix");
+  auto *vec=grp->createChildObject<SimpleDataset<vector<string> > >("vector")(3);
+  vec->write({"a", "bb", "ccc"});
+  file.reopenAsSWMR();
+  for(int i=0; i<95; ++i) {
+    ts->append(vector<double>{i*1e-3, sin(i*0.1), i==7 ? NAN : -i*1e10});
+    tsu->append(vector<int>{-i, i});
+  }
+  }
+
 
 
 //  /***** MYMATRIXSERIE *****/
@@ -0,0 +1,113 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+
+#include <config.h>
+#include "chunkcodec.h"
+#include "predictfilter.h"
+#include <cstring>
+#include <stdexcept>
+#include <zlib.h>
+
+using namespace std;
+
+namespace {
+  // same format as the HDF5 shuffle filter
+  vector<char> shuffle(const vector<char> &in, size_t elemSize, bool reverse) {
+    vector<char> out(in.size());
+    size_t n=in.size()/elemSize;
+    for(size_t b=0; b<elemSize; ++b)
+      for(size_t i=0; i<n; ++i)
+        if(!reverse)
+          out[b*n+i]=in[i*elemSize+b];
+        else
+          out[i*elemSize+b]=in[b*n+i];
+    // trailing bytes are not shuffled
+    memcpy(out.data()+n*elemSize, in.data()+n*elemSize, in.size()-n*elemSize);
+    return out;
+  }
+}
+
+namespace H5 {
+
+ChunkCodec::ChunkCodec(hid_t dcpl) {
+  int nFilters=H5Pget_nfilters(dcpl);
+  for(int i=0; i<nFilters; ++i) {
+    Filter f;
+    unsigned int flags;
+    size_t nCdValues=0;
+    H5Pget_filter2(dcpl, i, &flags, &nCdValues, nullptr, 0, nullptr, nullptr);
+    f.cdValues.resize(nCdValues);
+    f.id=H5Pget_filter2(dcpl, i, &flags, &nCdValues, f.cdValues.data(), 0, nullptr, nullptr);
+    if(f.id!=H5Z_FILTER_DEFLATE && f.id!=H5Z_FILTER_SHUFFLE && f.id!=predictFilterID)
+      supported=false;
+    filters.push_back(f);
+  }
+}
+
+vector<char> ChunkCodec::encode(const char *data, size_t size) const {
+  if(!supported)
+    throw runtime_error("Internal error: the filter pipeline is not supported by ChunkCodec.");
+  vector<char> buf(data, data+size);
+  for(auto &f : filters) {
+    if(f.id==H5Z_FILTER_DEFLATE) {
+      uLongf outSize=compressBound(buf.size());
+      vector<char> out(outSize);
+      if(compress2(reinterpret_cast<Bytef*>(out.data()), &outSize, reinterpret_cast<const Bytef*>(buf.data()), buf.size(),
+                   f.cdValues.empty() ? Z_DEFAULT_COMPRESSION : f.cdValues[0])!=Z_OK)
+        throw runtime_error("Compressing a chunk failed.");
+      out.resize(outSize);
+      buf=std::move(out);
+    }
+    else if(f.id==H5Z_FILTER_SHUFFLE)
+      buf=shuffle(buf, f.cdValues.at(0), false);
+    else if(f.id==predictFilterID)
+      buf=predictEncode(buf.data(), buf.size(), f.cdValues);
+  }
+  return buf;
+}
+
+vector<char> ChunkCodec::decode(vector<char> data, unsigned filterMask, size_t rawSize) const {
+  if(!supported)
+    throw runtime_error("Internal error: the filter pipeline is not supported by ChunkCodec.");
+  for(int i=filters.size()-1; i>=0; --i) {
+    if(filterMask & (1u<<i))
+      continue;
+    auto &f=filters[i];
+    if(f.id==H5Z_FILTER_DEFLATE) {
+      uLongf outSize=rawSize;
+      vector<char> out(outSize);
+      if(uncompress(reinterpret_cast<Bytef*>(out.data()), &outSize, reinterpret_cast<const Bytef*>(data.data()), data.size())!=Z_OK)
+        throw runtime_error("Decompressing a chunk failed.");
+      out.resize(outSize);
+      data=std::move(out);
+    }
+    else if(f.id==H5Z_FILTER_SHUFFLE)
+      data=shuffle(data, f.cdValues.at(0), true);
+    else if(f.id==predictFilterID)
+      data=predictDecode(data.data(), data.size(), f.cdValues);
+  }
+  if(data.size()!=rawSize)
+    throw runtime_error("Decoding a chunk resulted in a wrong size.");
+  return data;
+}
+
+}
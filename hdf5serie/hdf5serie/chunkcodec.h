@@ -0,0 +1,57 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+
+#ifndef _HDF5SERIE_CHUNKCODEC_H_
+#define _HDF5SERIE_CHUNKCODEC_H_
+
+#include <hdf5.h>
+#include <vector>
+
+namespace H5 {
+
+// The filter pipeline of a chunked dataset, applied by this library itself instead of by the HDF5 filter pipeline.
+// Used for direct chunk write/read (H5Dwrite_chunk/H5Dread_chunk), e.g. to encode/decode chunks in worker threads.
+// Only some filters are known (deflate, shuffle and the predictive filter of this library), see isSupported().
+// The functions of this class do not call any HDF5 function and can hence be called from any thread.
+class ChunkCodec {
+  public:
+    ChunkCodec(hid_t dcpl);
+    // true if all filters of the pipeline are known by this class
+    bool isSupported() const { return supported; }
+    // true if the pipeline contains no filter
+    bool isEmpty() const { return filters.empty(); }
+    // apply all filters of the pipeline to the chunk data of size bytes (the filter mask of the result is 0)
+    std::vector<char> encode(const char *data, size_t size) const;
+    // reverse all filters of the pipeline not masked out by filterMask; the decoded chunk has rawSize bytes
+    std::vector<char> decode(std::vector<char> data, unsigned filterMask, size_t rawSize) const;
+  private:
+    struct Filter {
+      H5Z_filter_t id;
+      std::vector<unsigned int> cdValues;
+    };
+    std::vector<Filter> filters;
+    bool supported { true };
+};
+
+}
+
+#endif
@@ -0,0 +1,164 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include "companiondataset.h"
+
+using namespace std;
+
+namespace H5 {
+
+bool CompanionDataset::exists(hid_t parent, const string &name) {
+  return H5Lexists(parent, name.c_str(), H5P_DEFAULT)>0;
+}
+
+bool CompanionDataset::isCompanion(hid_t parent, const string &name) {
+  if(name.size()<3 || name[0]!='.')
+    return false;
+  size_t dot=name.rfind('.');
+  if(dot<2)
+    return false;
+  string kind=name.substr(dot+1);
+  bool knownKind=kind=="zonemap" || kind=="timeindex" ||
+    (kind.size()>7 && kind.compare(0, 7, "pyramid")==0 && kind.find_first_not_of("0123456789", 7)==string::npos);
+  return knownKind && exists(parent, name.substr(1, dot-1));
+}
+
+CompanionDataset::CompanionDataset(hid_t parent, string name_, int cols_, hsize_t chunkRows_, int compression, hsize_t chunkCols) :
+  name(std::move(name_)), cols(cols_), chunkRows(chunkRows_) {
+  hsize_t dims[]={0, static_cast<hsize_t>(cols)};
+  hsize_t maxDims[]={H5S_UNLIMITED, dims[1]};
+  ScopedHID space(H5Screate_simple(2, dims, maxDims), &H5Sclose);
+  ScopedHID cpl(H5Pcreate(H5P_DATASET_CREATE), &H5Pclose);
+  hsize_t chunkDims[]={chunkRows, chunkCols>0 ? chunkCols : dims[1]};
+  H5Pset_chunk(cpl, 2, chunkDims);
+  if(compression>0) H5Pset_deflate(cpl, compression);
+  id.reset(H5Dcreate2(parent, name.c_str(), H5T_NATIVE_DOUBLE, space, H5P_DEFAULT, cpl, H5P_DEFAULT), &H5Dclose);
+}
+
+CompanionDataset::CompanionDataset(hid_t parent, string name_) : name(std::move(name_)) {
+  reopen(parent);
+  ScopedHID space(H5Dget_space(id), &H5Sclose);
+  if(H5Sget_simple_extent_ndims(space)!=2)
+    throw Exception(name, "A companion dataset must have 2 dimensions.");
+  hsize_t dims[2];
+  H5Sget_simple_extent_dims(space, dims, nullptr);
+  rows=dims[0];
+  cols=dims[1];
+  ScopedHID cpl(H5Dget_create_plist(id), &H5Pclose);
+  hsize_t chunkDims[2];
+  H5Pget_chunk(cpl, 2, chunkDims);
+  chunkRows=chunkDims[0];
+}
+
+void CompanionDataset::close() {
+  writeBuffer();
+  id.reset();
+}
+
+void CompanionDataset::reopen(hid_t parent) {
+  id.reset(H5Dopen(parent, name.c_str(), H5P_DEFAULT), &H5Dclose);
+}
+
+void CompanionDataset::flush() {
+  writeBuffer();
+#if H5_VERSION_GE(1, 10, 0)
+  H5Dflush(id);
+#endif
+}
+
+void CompanionDataset::refresh() {
+#if H5_VERSION_GE(1, 10, 0)
+  H5Drefresh(id);
+#endif
+}
+
+hsize_t CompanionDataset::getRows() {
+  ScopedHID space(H5Dget_space(id), &H5Sclose);
+  hsize_t dims[2];
+  H5Sget_simple_extent_dims(space, dims, nullptr);
+  rows=dims[0];
+  return rows;
+}
+
+void CompanionDataset::append(const double *data) {
+  buffer.insert(buffer.end(), data, data+cols);
+  if(buffer.size()>=chunkRows*cols)
+    writeBuffer();
+}
+
+void CompanionDataset::writeBuffer() {
+  if(buffer.empty())
+    return;
+  hsize_t count=buffer.size()/cols;
+  hsize_t start[]={rows, 0};
+  hsize_t cnt[]={count, static_cast<hsize_t>(cols)};
+  rows+=count;
+  hsize_t dims[]={rows, cnt[1]};
+  H5Dset_extent(id, dims);
+  ScopedHID fileSpace(H5Dget_space(id), &H5Sclose);
+  H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start, nullptr, cnt, nullptr);
+  ScopedHID memSpace(H5Screate_simple(2, cnt, nullptr), &H5Sclose);
+  H5Dwrite(id, H5T_NATIVE_DOUBLE, memSpace, fileSpace, H5P_DEFAULT, buffer.data());
+  buffer.clear();
+}
+
+vector<double> CompanionDataset::read(hsize_t start, hsize_t count, hsize_t colStart, hsize_t colStride, hsize_t colCount) {
+  vector<double> data(count*colCount);
+  if(data.empty())
+    return data;
+  hsize_t s[]={start, colStart};
+  hsize_t stride[]={1, colStride};
+  hsize_t cnt[]={count, colCount};
+  ScopedHID fileSpace(H5Dget_space(id), &H5Sclose);
+  H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, s, stride, cnt, nullptr);
+  ScopedHID memSpace(H5Screate_simple(2, cnt, nullptr), &H5Sclose);
+  if(H5Dread(id, H5T_NATIVE_DOUBLE, memSpace, fileSpace, H5P_DEFAULT, data.data())<0)
+    throw Exception(name, "Reading the companion dataset failed.");
+  return data;
+}
+
+void CompanionDataset::setAttribute(const string &attrName, int value) {
+  ScopedHID space(H5Screate(H5S_SCALAR), &H5Sclose);
+  ScopedHID attr(H5Acreate2(id, attrName.c_str(), H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT), &H5Aclose);
+  H5Awrite(attr, H5T_NATIVE_INT, &value);
+}
+
+int CompanionDataset::getAttribute(const string &attrName) {
+  ScopedHID attr(H5Aopen(id, attrName.c_str(), H5P_DEFAULT), &H5Aclose);
+  int value;
+  H5Aread(attr, H5T_NATIVE_INT, &value);
+  return value;
+}
+
+int getDeflateLevel(hid_t dcpl) {
+  int nFilters=H5Pget_nfilters(dcpl);
+  for(int i=0; i<nFilters; ++i) {
+    unsigned int flags;
+    size_t nCdValues=1;
+    unsigned int cdValues[1]={0};
+    if(H5Pget_filter2(dcpl, i, &flags, &nCdValues, cdValues, 0, nullptr, nullptr)==H5Z_FILTER_DEFLATE)
+      return cdValues[0];
+  }
+  return 0;
+}
+
+}
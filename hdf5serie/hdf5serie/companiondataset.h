@@ -0,0 +1,82 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#ifndef _HDF5SERIE_COMPANIONDATASET_H_
+#define _HDF5SERIE_COMPANIONDATASET_H_
+
+#include <hdf5serie/interface.h>
+#include <string>
+#include <vector>
+
+namespace H5 {
+
+// A 2D double dataset with a unlimited number of rows, stored next to a dataset of this library to hold
+// derived data (e.g. a min/max pyramid or a index) of this dataset. The name of a companion dataset is
+// ".<name of the dataset>.<kind>": such names are not listed by GroupBase::getChildObjectNames (see isCompanion).
+// Companion datasets are handled by the dataset they belong to and are not part of the object tree.
+class CompanionDataset {
+  public:
+    static std::string getName(const std::string &dataset, const std::string &kind) { return "."+dataset+"."+kind; }
+    static bool exists(hid_t parent, const std::string &name);
+    // true if name is the name of a companion dataset: ".<name>.<kind>" with a known kind and a existing object <name>
+    // in parent. Other names starting with a "." are ordinary objects.
+    static bool isCompanion(hid_t parent, const std::string &name);
+    // create a new companion dataset with cols columns (chunked with chunkRows rows and chunkCols columns (0 = all columns)
+    // and deflate compression)
+    CompanionDataset(hid_t parent, std::string name_, int cols, hsize_t chunkRows, int compression, hsize_t chunkCols=0);
+    // open the existing companion dataset
+    CompanionDataset(hid_t parent, std::string name_);
+    CompanionDataset(const CompanionDataset&) = delete;
+    CompanionDataset& operator=(const CompanionDataset&) = delete;
+
+    // close the dataset (e.g. before the file is reopened) and open it again (close and flush write the buffered rows)
+    void close();
+    void reopen(hid_t parent);
+    void flush();
+    void refresh();
+
+    hsize_t getRows(); // the current number of rows in the file (without the buffered rows)
+    int getColumns() { return cols; }
+    // append a row (of getColumns() values); the rows are buffered and written when a chunk is complete or on
+    // flush/close (also a incomplete chunk, so SWMR readers see all rows appended before the flush)
+    void append(const double *data);
+    // read the rows [start, start+count[ and the columns colStart, colStart+colStride, ... (colCount columns)
+    std::vector<double> read(hsize_t start, hsize_t count, hsize_t colStart, hsize_t colStride, hsize_t colCount);
+
+    void setAttribute(const std::string &attrName, int value);
+    int getAttribute(const std::string &attrName);
+
+  private:
+    std::string name;
+    ScopedHID id;
+    int cols;
+    hsize_t rows { 0 };
+    hsize_t chunkRows { 0 };
+    std::vector<double> buffer;
+    void writeBuffer();
+};
+
+// returns the deflate compression level of the dataset creation property list dcpl (0 = no deflate filter)
+int getDeflateLevel(hid_t dcpl);
+
+}
+
+#endif
@@ -0,0 +1,237 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include "binaryoutput.h"
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+// A minimal FlatBuffers writer, as needed for the metadata of the Arrow IPC messages.
+// Objects are appended one after the other; the first table is the root table. References (offsets) always point to
+// objects appended later and are set using ref when the referenced object has been appended.
+class FlatBuffer {
+  public:
+    FlatBuffer() {
+      append<uint32_t>(0); // offset of the root table
+    }
+
+    // Appends a table with fields of the given sizes in bytes (0 = field not present).
+    // Returns the position of the table; pos is set to the position of each field.
+    size_t addTable(const vector<size_t> &size, vector<size_t> &pos) {
+      // layout: the vtable offset followed by the fields, each aligned to its size
+      vector<uint16_t> offset(size.size(), 0);
+      size_t inlineSize=4;
+      for(size_t i=0; i<size.size(); ++i)
+        if(size[i]>0) {
+          inlineSize=(inlineSize+size[i]-1)/size[i]*size[i];
+          offset[i]=inlineSize;
+          inlineSize+=size[i];
+        }
+      // the vtable is placed before the table
+      align(2);
+      size_t vtable=buf.size();
+      append<uint16_t>(4+2*size.size());
+      append<uint16_t>(inlineSize);
+      for(auto o : offset)
+        append<uint16_t>(o);
+      align(8);
+      size_t table=buf.size();
+      buf.resize(table+inlineSize, 0);
+      put<int32_t>(table, table-vtable);
+      if(get<uint32_t>(0)==0)
+        put<uint32_t>(0, table);
+      pos.resize(size.size());
+      for(size_t i=0; i<size.size(); ++i)
+        pos[i]=table+offset[i];
+      return table;
+    }
+
+    // Appends a string and returns its position.
+    size_t addString(const string &str) {
+      align(4);
+      size_t p=buf.size();
+      append<uint32_t>(str.size());
+      buf.insert(buf.end(), str.begin(), str.end());
+      buf.push_back(0);
+      return p;
+    }
+
+    // Appends a vector of n elements of elemSize bytes each (aligned to elemAlign) and returns its position
+    // (the elements start at the returned position + 4).
+    size_t addVector(size_t n, size_t elemSize, size_t elemAlign) {
+      align(4);
+      while((buf.size()+4)%elemAlign!=0)
+        buf.push_back(0);
+      size_t p=buf.size();
+      append<uint32_t>(n);
+      buf.resize(buf.size()+n*elemSize, 0);
+      return p;
+    }
+
+    // Sets the offset at position field to reference the object at position target.
+    void ref(size_t field, size_t target) {
+      put<uint32_t>(field, target-field);
+    }
+
+    template<class T>
+    void put(size_t at, T value) {
+      memcpy(&buf[at], &value, sizeof(T));
+    }
+
+    const vector<char>& data() {
+      align(8);
+      return buf;
+    }
+
+  private:
+    vector<char> buf;
+
+    void align(size_t a) {
+      while(buf.size()%a!=0)
+        buf.push_back(0);
+    }
+
+    template<class T>
+    void append(T value) {
+      buf.resize(buf.size()+sizeof(T));
+      put<T>(buf.size()-sizeof(T), value);
+    }
+
+    template<class T>
+    T get(size_t at) {
+      T value;
+      memcpy(&value, &buf[at], sizeof(T));
+      return value;
+    }
+};
+
+template<class T>
+void write(ostream &os, T value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Arrow format constants (see format/Schema.fbs and format/Message.fbs of Apache Arrow)
+const int16_t arrowMetadataVersionV5=4;
+const uint8_t arrowMessageHeaderSchema=1;
+const uint8_t arrowMessageHeaderRecordBatch=3;
+const uint8_t arrowTypeFloatingPoint=3;
+const int16_t arrowPrecisionDouble=2;
+
+// Appends a Message table (the root table) and returns the position of its header field
+size_t arrowMessage(FlatBuffer &fb, uint8_t headerType, int64_t bodyLength) {
+  vector<size_t> pos;
+  // version, header_type, header, bodyLength
+  fb.addTable({2, 1, 4, 8}, pos);
+  fb.put<int16_t>(pos[0], arrowMetadataVersionV5);
+  fb.put<uint8_t>(pos[1], headerType);
+  fb.put<int64_t>(pos[3], bodyLength);
+  return pos[2];
+}
+
+// Writes a encapsulated message: continuation marker, metadata size, metadata (padded to 8 bytes), body
+void writeArrowMessage(ostream &os, FlatBuffer &fb, const char *body, size_t bodySize) {
+  auto &meta=fb.data();
+  write<uint32_t>(os, 0xFFFFFFFF);
+  write<int32_t>(os, meta.size());
+  os.write(meta.data(), meta.size());
+  os.write(body, bodySize);
+}
+
+}
+
+bool isLittleEndian() {
+  uint16_t one=1;
+  char c;
+  memcpy(&c, &one, 1);
+  return c==1;
+}
+
+size_t writeNpyHeader(ostream &os, size_t rows, size_t cols) {
+  string dict="{'descr': '<f8', 'fortran_order': True, 'shape': ("+to_string(rows)+", "+to_string(cols)+"), }";
+  // magic, version 1.0, header length, dict padded with spaces and terminated by a newline to a multiple of 64 bytes
+  size_t size=(10+dict.size()+1+63)/64*64;
+  dict.resize(size-10-1, ' ');
+  dict+='\n';
+  os.write("\x93NUMPY\x01\x00", 8);
+  write<uint16_t>(os, dict.size());
+  os.write(dict.data(), dict.size());
+  return size;
+}
+
+void writeArrowSchema(ostream &os, const vector<string> &name) {
+  FlatBuffer fb;
+  size_t header=arrowMessage(fb, arrowMessageHeaderSchema, 0);
+  vector<size_t> schema;
+  // endianness (little), fields
+  fb.ref(header, fb.addTable({2, 4}, schema));
+  size_t fields=fb.addVector(name.size(), 4, 4);
+  fb.ref(schema[1], fields);
+  for(size_t i=0; i<name.size(); ++i) {
+    vector<size_t> field, type;
+    // name, nullable, type_type, type, dictionary (not present), children
+    fb.ref(fields+4+4*i, fb.addTable({4, 1, 1, 4, 0, 4}, field));
+    fb.put<uint8_t>(field[1], 1);
+    fb.put<uint8_t>(field[2], arrowTypeFloatingPoint);
+    fb.ref(field[0], fb.addString(name[i]));
+    // precision
+    fb.ref(field[3], fb.addTable({2}, type));
+    fb.put<int16_t>(type[0], arrowPrecisionDouble);
+    fb.ref(field[5], fb.addVector(0, 4, 4));
+  }
+  writeArrowMessage(os, fb, nullptr, 0);
+}
+
+void writeArrowRecordBatch(ostream &os, size_t rows, const vector<double> &data) {
+  size_t cols=rows>0 ? data.size()/rows : 0;
+  size_t colSize=rows*sizeof(double);
+  FlatBuffer fb;
+  size_t header=arrowMessage(fb, arrowMessageHeaderRecordBatch, cols*colSize);
+  vector<size_t> batch;
+  // length, nodes, buffers
+  fb.ref(header, fb.addTable({8, 4, 4}, batch));
+  fb.put<int64_t>(batch[0], rows);
+  // a field node (length, null count) per column
+  size_t nodes=fb.addVector(cols, 16, 8);
+  fb.ref(batch[1], nodes);
+  for(size_t c=0; c<cols; ++c) {
+    fb.put<int64_t>(nodes+4+16*c, rows);
+    fb.put<int64_t>(nodes+4+16*c+8, 0);
+  }
+  // a validity buffer (empty, no nulls) and a data buffer (offset, length) per column
+  size_t buffers=fb.addVector(2*cols, 16, 8);
+  fb.ref(batch[2], buffers);
+  for(size_t c=0; c<cols; ++c) {
+    fb.put<int64_t>(buffers+4+32*c, c*colSize);
+    fb.put<int64_t>(buffers+4+32*c+8, 0);
+    fb.put<int64_t>(buffers+4+32*c+16, c*colSize);
+    fb.put<int64_t>(buffers+4+32*c+24, colSize);
+  }
+  writeArrowMessage(os, fb, reinterpret_cast<const char*>(data.data()), cols*colSize);
+}
+
+void writeArrowEndOfStream(ostream &os) {
+  write<uint32_t>(os, 0xFFFFFFFF);
+  write<int32_t>(os, 0);
+}
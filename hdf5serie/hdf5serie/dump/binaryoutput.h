@@ -0,0 +1,48 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#ifndef _HDF5SERIE_BINARYOUTPUT_H_
+#define _HDF5SERIE_BINARYOUTPUT_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Binary output formats of h5dumpserie. All values are written as little endian double.
+
+// Returns true if the host is little endian (the binary formats are only supported on such hosts).
+bool isLittleEndian();
+
+// Writes the header of a NumPy .npy file of rows x cols doubles in column-major (Fortran) order.
+// Returns the size of the header, the data follows directly.
+size_t writeNpyHeader(std::ostream &os, size_t rows, size_t cols);
+
+// Writes the schema message of a Arrow IPC stream with one float64 column per name.
+void writeArrowSchema(std::ostream &os, const std::vector<std::string> &name);
+
+// Writes a record batch message of a Arrow IPC stream with rows rows.
+// data contains the values of all columns one after the other (rows values per column).
+void writeArrowRecordBatch(std::ostream &os, size_t rows, const std::vector<double> &data);
+
+// Writes the end-of-stream marker of a Arrow IPC stream.
+void writeArrowEndOfStream(std::ostream &os);
+
+#endif
@@ -0,0 +1,115 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include "datasetinfo.h"
+#include <hdf5serie/interface.h>
+#include <cstring>
+
+using namespace std;
+using namespace H5;
+
+namespace {
+
+// a short name of the HDF5 datatype type
+string typeName(hid_t type) {
+  switch(H5Tget_class(type)) {
+    case H5T_INTEGER: return (H5Tget_sign(type)==H5T_SGN_NONE ? "uint" : "int")+to_string(8*H5Tget_size(type));
+    case H5T_FLOAT: return "float"+to_string(8*H5Tget_size(type));
+    case H5T_STRING: return "string";
+    case H5T_COMPOUND: return "compound";
+    default: return "other";
+  }
+}
+
+}
+
+DatasetInfo getDatasetInfo(hid_t dataset) {
+  DatasetInfo info;
+  ScopedHID type(H5Dget_type(dataset), &H5Tclose);
+  info.datatype=typeName(type);
+  info.typeSize=H5Tis_variable_str(type)>0 || H5Tdetect_class(type, H5T_VLEN)>0 ? 0 : H5Tget_size(type);
+
+  ScopedHID space(H5Dget_space(dataset), &H5Sclose);
+  int rank=max(0, H5Sget_simple_extent_ndims(space));
+  info.dims.resize(rank);
+  info.maxDims.resize(rank);
+  H5Sget_simple_extent_dims(space, info.dims.data(), info.maxDims.data());
+
+  ScopedHID cpl(H5Dget_create_plist(dataset), &H5Pclose);
+  if(H5Pget_layout(cpl)==H5D_CHUNKED) {
+    info.chunk.resize(rank);
+    H5Pget_chunk(cpl, rank, info.chunk.data());
+  }
+  for(int i=0; i<H5Pget_nfilters(cpl); ++i) {
+    unsigned flags;
+    size_t nParam=0;
+    char name[256];
+    unsigned config;
+    // query the number of parameters first (e.g. the predictive filter has a parameter per column)
+    H5Pget_filter2(cpl, i, &flags, &nParam, nullptr, 0, nullptr, &config);
+    vector<unsigned> param(nParam);
+    H5Z_filter_t id=H5Pget_filter2(cpl, i, &flags, &nParam, param.data(), sizeof(name), name, &config);
+    if(id==H5Z_FILTER_DEFLATE && !param.empty())
+      info.compression=param[0];
+    info.filters.push_back({id, id==H5Z_FILTER_DEFLATE ? "deflate" : id==H5Z_FILTER_SHUFFLE ? "shuffle" : name,
+                            std::move(param)});
+  }
+
+  info.storageSize=H5Dget_storage_size(dataset);
+  return info;
+}
+
+vector<string> readStringAttribute(hid_t id, const string &name) {
+  vector<string> ret;
+  if(H5Aexists(id, name.c_str())<=0)
+    return ret;
+  ScopedHID a(H5Aopen(id, name.c_str(), H5P_DEFAULT), &H5Aclose);
+  ScopedHID type(H5Aget_type(a), &H5Tclose);
+  if(H5Tget_class(type)!=H5T_STRING)
+    return ret;
+  ScopedHID space(H5Aget_space(a), &H5Sclose);
+  hssize_t n=H5Sget_simple_extent_npoints(space);
+  if(H5Tis_variable_str(type)>0) {
+    ScopedHID memType(H5Tcopy(H5T_C_S1), &H5Tclose);
+    H5Tset_size(memType, H5T_VARIABLE);
+    vector<char*> buf(n);
+    H5Aread(a, memType, buf.data());
+    for(auto *s : buf)
+      ret.emplace_back(s ? s : "");
+    H5Dvlen_reclaim(memType, space, H5P_DEFAULT, buf.data());
+  }
+  else {
+    size_t size=H5Tget_size(type);
+    vector<char> buf(n*size);
+    H5Aread(a, type, buf.data());
+    for(hssize_t i=0; i<n; ++i)
+      ret.emplace_back(buf.data()+i*size, strnlen(buf.data()+i*size, size));
+  }
+  return ret;
+}
+
+string dimString(const vector<hsize_t> &dims) {
+  string ret;
+  for(size_t i=0; i<dims.size(); ++i)
+    ret+=(i==0?"":" x ")+(dims[i]==H5S_UNLIMITED ? string("unlimited") : to_string(dims[i]));
+  return ret;
+}
@@ -0,0 +1,58 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#ifndef _HDF5SERIE_DATASETINFO_H_
+#define _HDF5SERIE_DATASETINFO_H_
+
+#include <hdf5.h>
+#include <string>
+#include <vector>
+
+// Metadata of HDF5 datasets as shown by h5lsserie and h5statserie.
+// All functions work on plain HDF5 ids: the datasets do not need to be opened as hdf5serie objects and no raw data
+// is read.
+
+struct FilterInfo {
+  H5Z_filter_t id;
+  std::string name;
+  std::vector<unsigned> param;
+};
+
+struct DatasetInfo {
+  std::string datatype;        // short type name like "float64", "int32", "string"
+  size_t typeSize { 0 };       // size of a element in the file (0 for variable length types)
+  std::vector<hsize_t> dims, maxDims;
+  std::vector<hsize_t> chunk;  // empty if the dataset is not chunked
+  std::vector<FilterInfo> filters;
+  int compression { 0 };       // deflate level (0 if not compressed)
+  hsize_t storageSize { 0 };   // size of the raw data in the file (H5Dget_storage_size)
+};
+
+// Returns the metadata of the dataset.
+DatasetInfo getDatasetInfo(hid_t dataset);
+
+// Returns the value of the string or string vector attribute name of the HDF5 object id (empty if it does not exist).
+std::vector<std::string> readStringAttribute(hid_t id, const std::string &name);
+
+// Returns the dimensions dims as "d0 x d1 ..." ("unlimited" for H5S_UNLIMITED).
+std::string dimString(const std::vector<hsize_t> &dims);
+
+#endif
@@ -26,9 +26,17 @@
 #include <hdf5serie/vectorserie.h>
 #include <hdf5serie/simpledataset.h>
 #include <hdf5serie/toh5type.h>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
 #include <iomanip>
 #include <limits>
+#include <sstream>
+#include <thread>
 #include <boost/lexical_cast.hpp>
+#include "binaryoutput.h"
 
 using namespace H5;
 using namespace std;
@@ -60,8 +68,185 @@ string quote="\"";
 string delim=" ";
 string mynan="nan";
 int precision=numeric_limits<double>::digits10+1;
+bool shortest=false;
 
-void printRow(Dataset *d, int row);
+// append the value v to out: floating point values in scientific format with precision digits (or the shortest
+// representation which reads back exactly), characters as characters and all other values as integers
+template<class T>
+void format(string &out, const T &v) {
+  if constexpr(is_same_v<T, string>)
+    out+=v;
+  else if constexpr(is_same_v<T, char> || is_same_v<T, signed char> || is_same_v<T, unsigned char>)
+    out+=static_cast<char>(v);
+  else {
+    char buf[128];
+    to_chars_result r;
+    if constexpr(is_floating_point_v<T>)
+      r=shortest ? to_chars(buf, buf+sizeof(buf), v) : to_chars(buf, buf+sizeof(buf), v, chars_format::scientific, precision);
+    else
+      r=to_chars(buf, buf+sizeof(buf), v);
+    if(r.ec==errc())
+      out.append(buf, r.ptr);
+    else { // very large precision
+      ostringstream str;
+      str<<setprecision(precision)<<scientific<<v;
+      out+=str.str();
+    }
+  }
+}
+
+string quoteString(hid_t type);
+
+// Reads the selected columns of a dataset in blocks of rows and prints the rows of the current block
+class BlockReader {
+  public:
+    virtual ~BlockReader() = default;
+    // the number of rows of the dataset (determined once)
+    unsigned int getRows() { return rows; }
+    // read count rows starting at first with a step of stride (rows beyond the end of the dataset are not read)
+    virtual void read(unsigned int first, unsigned int count, unsigned int stride) = 0;
+    // the row range of the time window [tBegin, tEnd] (the values of the time index column or the first column of the dataset)
+    virtual pair<unsigned int, unsigned int> findRowRange(double tBegin, double tEnd) {
+      throw runtime_error("A time window can only be selected for numeric VectorSerie datasets.");
+    }
+    // append row (of the current block) to out; may be called by several threads concurrently
+    virtual void printRow(string &out, unsigned int row) const = 0;
+    // true if rows can be appended to the dataset (by a writer process)
+    bool canGrow() { return growing; }
+    // determine the number of rows again
+    virtual void refresh() {}
+    // true if the values can be converted to double (all but string datasets)
+    bool isNumeric() { return numeric; }
+    // store the values of row (of the current block) converted to double in v
+    virtual void getValues(double *v, unsigned int row) const = 0;
+  protected:
+    unsigned int rows { 0 };
+    bool numeric { true };
+    bool growing { false };
+};
+
+template<class T>
+double toDouble(const T &v) {
+  if constexpr(is_same_v<T, string>)
+    throw runtime_error("Internal error: a string cannot be converted to double.");
+  else
+    return static_cast<double>(v);
+}
+
+template<class T>
+class VectorSerieBlockReader : public BlockReader {
+  public:
+    VectorSerieBlockReader(VectorSerie<T> *vs_, const vector<int> &column, const string &quote_) : vs(vs_), quote(quote_) {
+      rows=vs->getRows();
+      numeric=!is_same_v<T, string>;
+      growing=true;
+      for(int c : column)
+        col.push_back(c-1);
+    }
+    void refresh() override {
+      rows=vs->getRows();
+    }
+    void read(unsigned int first_, unsigned int count, unsigned int stride_) override {
+      first=first_;
+      stride=stride_;
+      count=first<rows ? min(count, (rows-first+stride-1)/stride) : 0;
+      data.resize(count*col.size());
+      if(count>0)
+        vs->getRowRange(first, count, col, data.size(), data.data(), stride);
+    }
+    pair<unsigned int, unsigned int> findRowRange(double tBegin, double tEnd) override {
+      if constexpr(is_same_v<T, string>)
+        return BlockReader::findRowRange(tBegin, tEnd);
+      else
+        return vs->findRowRange(tBegin, tEnd);
+    }
+    void printRow(string &out, unsigned int row) const override {
+      const T *d=&data[(row-first)/stride*col.size()];
+      for(size_t i=0; i<col.size(); ++i) {
+        if(i>0) out+=delim;
+        out+=quote;
+        format(out, d[i]);
+        out+=quote;
+      }
+    }
+    void getValues(double *v, unsigned int row) const override {
+      const T *d=&data[(row-first)/stride*col.size()];
+      for(size_t i=0; i<col.size(); ++i)
+        v[i]=toDouble(d[i]);
+    }
+  private:
+    VectorSerie<T> *vs;
+    string quote;
+    vector<int> col; // the selected columns (starting with 0)
+    unsigned int first { 0 }; // the first row of the current block
+    unsigned int stride { 1 }; // the step between the rows of the current block
+    vector<T> data;
+};
+
+// a SimpleDataset is read completely, once
+template<class T>
+class SimpleVectorBlockReader : public BlockReader {
+  public:
+    SimpleVectorBlockReader(SimpleDataset<vector<T> > *d, const string &quote_) : quote(quote_), data(d->read()) {
+      rows=data.size();
+      numeric=!is_same_v<T, string>;
+    }
+    void read(unsigned int first, unsigned int count, unsigned int stride) override {}
+    void printRow(string &out, unsigned int row) const override {
+      out+=quote;
+      format(out, data[row]);
+      out+=quote;
+    }
+    void getValues(double *v, unsigned int row) const override {
+      v[0]=toDouble(data[row]);
+    }
+  private:
+    string quote;
+    vector<T> data;
+};
+
+template<class T>
+class SimpleMatrixBlockReader : public BlockReader {
+  public:
+    SimpleMatrixBlockReader(SimpleDataset<vector<vector<T> > > *d, const vector<int> &column, const string &quote_) :
+      quote(quote_), data(d->read()) {
+      rows=data.size();
+      numeric=!is_same_v<T, string>;
+      for(int c : column)
+        col.push_back(c-1);
+    }
+    void read(unsigned int first, unsigned int count, unsigned int stride) override {}
+    void printRow(string &out, unsigned int row) const override {
+      for(size_t i=0; i<col.size(); ++i) {
+        if(i>0) out+=delim;
+        out+=quote;
+        format(out, data[row][col[i]]);
+        out+=quote;
+      }
+    }
+    void getValues(double *v, unsigned int row) const override {
+      for(size_t i=0; i<col.size(); ++i)
+        v[i]=toDouble(data[row][col[i]]);
+    }
+  private:
+    string quote;
+    vector<int> col; // the selected columns (starting with 0)
+    vector<vector<T> > data;
+};
+
+// returns a block reader for the dataset or nullptr if the dataset cannot be dumped
+shared_ptr<BlockReader> createBlockReader(Dataset *d, const vector<int> &column) {
+# define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
+  if(auto *dd=dynamic_cast<VectorSerie<CTYPE>*>(d)) \
+    return make_shared<VectorSerieBlockReader<CTYPE> >(dd, column, quoteString(H5TYPE)); \
+  if(auto *dd=dynamic_cast<SimpleDataset<vector<CTYPE> >*>(d)) \
+    return make_shared<SimpleVectorBlockReader<CTYPE> >(dd, quoteString(H5TYPE)); \
+  if(auto *dd=dynamic_cast<SimpleDataset<vector<vector<CTYPE> > >*>(d)) \
+    return make_shared<SimpleMatrixBlockReader<CTYPE> >(dd, column, quoteString(H5TYPE));
+# include "hdf5serie/knowntypes.def"
+# undef FOREACHKNOWNTYPE
+  return nullptr;
+}
 
 int main(int argc, char* argv[]) {
 #ifndef _WIN32
@@ -120,10 +305,112 @@ int main(int argc, char* argv[]) {
     arg.erase(i, i+2);
   }
 
+  i=find(arg.begin(), arg.end(), "-r");
+  if(i!=arg.end()) {
+    shortest=true;
+    arg.erase(i);
+  }
+
+  string binary;
+  i=find(arg.begin(), arg.end(), "-b");
+  if(i!=arg.end()) {
+    binary=*(i+1);
+    arg.erase(i, i+2);
+    if(binary!="raw" && binary!="npy" && binary!="arrow") {
+      cerr<<"Unknown binary output format "<<binary<<"."<<endl;
+      return 1;
+    }
+    if(!isLittleEndian()) {
+      cerr<<"Binary output is only supported on little endian hosts."<<endl;
+      return 1;
+    }
+    header=false;
+  }
+
+  bool follow=false;
+  i=find(arg.begin(), arg.end(), "--follow");
+  if(i!=arg.end()) {
+    follow=true;
+    arg.erase(i);
+  }
+
+  double interval=1;
+  i=find(arg.begin(), arg.end(), "--interval");
+  if(i!=arg.end()) {
+    interval=boost::lexical_cast<double>(*(i+1));
+    arg.erase(i, i+2);
+  }
+
+  // the row selection: --rows [<begin>]:[<end>] (negative = from the end), --stride <n>, --time [<tBegin>]:[<tEnd>]
+  auto parseRange=[](const string &str, auto &begin, auto &end) {
+    size_t pos=str.find(':');
+    if(pos==string::npos)
+      throw runtime_error("A range must be of the form [<begin>]:[<end>].");
+    if(pos>0) begin=boost::lexical_cast<remove_reference_t<decltype(begin)> >(str.substr(0, pos));
+    if(pos+1<str.size()) end=boost::lexical_cast<remove_reference_t<decltype(end)> >(str.substr(pos+1));
+  };
+  long long rowsBegin=0, rowsEnd=numeric_limits<long long>::max();
+  i=find(arg.begin(), arg.end(), "--rows");
+  if(i!=arg.end()) {
+    parseRange(*(i+1), rowsBegin, rowsEnd);
+    arg.erase(i, i+2);
+  }
+  unsigned int stride=1;
+  i=find(arg.begin(), arg.end(), "--stride");
+  if(i!=arg.end()) {
+    stride=max(1, boost::lexical_cast<int>(*(i+1)));
+    arg.erase(i, i+2);
+  }
+  bool timeWindow=false;
+  double tBegin=-numeric_limits<double>::infinity(), tEnd=numeric_limits<double>::infinity();
+  i=find(arg.begin(), arg.end(), "--time");
+  if(i!=arg.end()) {
+    timeWindow=true;
+    parseRange(*(i+1), tBegin, tEnd);
+    arg.erase(i, i+2);
+    if(isnan(tBegin) || isnan(tEnd)) {
+      cerr<<"The bounds of --time must not be NaN."<<endl;
+      return 1;
+    }
+  }
+
+  string outputFile;
+  i=find(arg.begin(), arg.end(), "-o");
+  if(i!=arg.end()) {
+    outputFile=*(i+1);
+    arg.erase(i, i+2);
+  }
+  // raw and npy are written column by column at the final position of each block
+  if((binary=="raw" || binary=="npy") && outputFile.empty()) {
+    cerr<<"The binary output formats raw and npy require a output file (-o <file>)."<<endl;
+    return 1;
+  }
+  if((binary=="raw" || binary=="npy") && follow) {
+    cerr<<"The binary output formats raw and npy cannot be used with --follow."<<endl;
+    return 1;
+  }
+  ofstream outFile;
+  if(!outputFile.empty()) {
+    outFile.open(outputFile, binary.empty() ? ios::out : ios::out | ios::binary);
+    if(!outFile) {
+      cerr<<"Cannot open the output file "<<outputFile<<"."<<endl;
+      return 1;
+    }
+  }
+  ostream &os=outputFile.empty() ? cout : outFile;
+
+  int threads=File::getNumberOfWorkerThreads();
+  i=find(arg.begin(), arg.end(), "-t");
+  if(i!=arg.end()) {
+    threads=max(1, boost::lexical_cast<int>(*(i+1)));
+    arg.erase(i, i+2);
+  }
+
   unsigned int maxrows=0;
   vector<vector<int> > column(arg.size());
   vector<Dataset*> dataSet(arg.size());
   vector<std::shared_ptr<File> > file(arg.size());
+  vector<string> label; // the label of each output column (column label or file/dataset:column)
   int col=1;
   for(unsigned int k=0; k<arg.size(); k++) {
     string para=arg[k];
@@ -173,11 +460,16 @@ int main(int argc, char* argv[]) {
             column[k].push_back(j);
       }
     }
+    vector<string> cols;
+    if(dataSet[k]->hasChildAttribute("Column Label"))
+      cols=dataSet[k]->openChildAttribute<SimpleAttribute<vector<string> > >("Column Label")->read();
+    for(int j : column[k])
+      label.push_back(cols.empty() ? filename+datasetname+":"+to_string(j) : cols[j-1]);
     if(header) {
-      cout<<comment<<" File/DataSet: "<<filename<<datasetname<<endl;
+      os<<comment<<" File/DataSet: "<<filename<<datasetname<<endl;
       if(dataSet[k]->hasChildAttribute("Description")) {
         string desc=dataSet[k]->openChildAttribute<SimpleAttribute<string> >("Description")->read();
-        cout<<comment<<"   Description: "<<desc<<endl;
+        os<<comment<<"   Description: "<<desc<<endl;
       }
 
 //      if(dataSet[k].getDataType().getClass()==H5T_COMPOUND) {
@@ -200,35 +492,191 @@ int main(int argc, char* argv[]) {
 //        }
 //      }
 //      else {
-        if(dataSet[k]->hasChildAttribute("Column Label")) {
-          vector<string> cols=dataSet[k]->openChildAttribute<SimpleAttribute<vector<string> > >("Column Label")->read();
-          cout<<comment<<"   Column Label:"<<endl;
+        if(!cols.empty()) {
+          os<<comment<<"   Column Label:"<<endl;
           for(int j : column[k])
-            cout<<comment<<"     "<<setfill('0')<<setw(4)<<col++<<": "<<cols[j-1]<<endl;
+            os<<comment<<"     "<<setfill('0')<<setw(4)<<col++<<": "<<cols[j-1]<<endl;
         }
         else
-          cout<<comment<<"   Column labels are not avaliable."<<endl;
+          os<<comment<<"   Column labels are not avaliable."<<endl;
 //      }
     }
   }
 
-  cout<<setprecision(precision)<<scientific;
-  for(unsigned int row=0; row<maxrows; row++) {
-    for(unsigned int k=0; k<arg.size(); k++) {
-      // Output mynan for to short datasets
-      vector<hsize_t> dims=dataSet[k]->getExtentDims();
-      if(row>=dims[0]) {
-        for(unsigned int i=0; i<column[k].size(); i++)
-          cout<<(k==0&&i==0?"":delim)<<mynan;
-        continue;
+  // VectorSeries are read in blocks of rows (only the selected columns), SimpleDatasets once
+  vector<shared_ptr<BlockReader> > reader(arg.size());
+  size_t selectedColumns=0;
+  for(unsigned int k=0; k<arg.size(); k++) {
+    reader[k]=createBlockReader(dataSet[k], column[k]);
+    selectedColumns+=column[k].size();
+  }
+  unsigned int blockRows=max<size_t>(1, (1<<20)/max<size_t>(1, selectedColumns));
+
+  // in follow mode only rows available in all VectorSeries are output (these rows do not change anymore)
+  auto availableRows=[&reader, maxrows]() {
+    unsigned int rows=numeric_limits<unsigned int>::max();
+    for(auto &r : reader)
+      if(r && r->canGrow())
+        rows=min(rows, r->getRows());
+    return rows==numeric_limits<unsigned int>::max() ? maxrows : rows;
+  };
+  unsigned int endRow=follow ? availableRows() : maxrows;
+
+  // the selected rows are first, first+stride, ... < last; negative --rows values count from the end
+  auto fromEnd=[endRow](long long r) {
+    return static_cast<unsigned int>(r<0 ? max(0LL, endRow+r) : min<long long>(r, numeric_limits<unsigned int>::max()));
+  };
+  unsigned int first=fromEnd(rowsBegin), last=fromEnd(rowsEnd);
+  auto timeWindowRows=[&]() {
+    if(!reader[0])
+      throw runtime_error("A time window can only be selected for numeric VectorSerie datasets.");
+    auto range=reader[0]->findRowRange(tBegin, tEnd);
+    first=range.first;
+    last=range.second;
+  };
+  if(timeWindow) {
+    if(rowsBegin!=0 || rowsEnd!=numeric_limits<long long>::max()) {
+      cerr<<"--rows and --time cannot be combined."<<endl;
+      return 1;
+    }
+    try {
+      timeWindowRows();
+    }
+    catch(const exception &ex) {
+      cerr<<ex.what()<<endl;
+      return 1;
+    }
+  }
+  // the number of selected rows before row end
+  auto selectedRows=[&first, &last, stride](unsigned int end) {
+    end=min(end, last);
+    return end>first ? (end-first+stride-1)/stride : 0;
+  };
+  unsigned int outputRows=selectedRows(endRow);
+
+  // output the selected rows [blockBegin, blockEnd[ (index of the selected rows) of the current block
+  function<void(unsigned int, unsigned int)> writeBlock;
+  vector<double> block, rowValues(selectedColumns);
+  size_t headerSize=0;
+  vector<string> out(threads);
+  if(!binary.empty()) {
+    for(auto &r : reader)
+      if(r && !r->isNumeric()) {
+        cerr<<"Binary output is not supported for string datasets."<<endl;
+        return 1;
+      }
+    if(binary=="npy")
+      headerSize=writeNpyHeader(os, outputRows, selectedColumns);
+    if(binary=="arrow")
+      writeArrowSchema(os, label);
+    writeBlock=[&](unsigned int blockBegin, unsigned int blockEnd) {
+      // the values of the block in column-major order, missing rows of to short datasets are NaN
+      size_t n=blockEnd-blockBegin;
+      block.resize(n*selectedColumns);
+      for(unsigned int j=blockBegin; j<blockEnd; j++) {
+        unsigned int row=first+j*stride;
+        double *v=rowValues.data();
+        for(unsigned int k=0; k<arg.size(); k++) {
+          if(!reader[k] || row>=reader[k]->getRows())
+            fill(v, v+column[k].size(), NAN);
+          else
+            reader[k]->getValues(v, row);
+          v+=column[k].size();
+        }
+        for(size_t c=0; c<selectedColumns; ++c)
+          block[c*n+j-blockBegin]=rowValues[c];
+      }
+      if(binary=="arrow")
+        writeArrowRecordBatch(os, n, block);
+      else
+        for(size_t c=0; c<selectedColumns; ++c) {
+          os.seekp(headerSize+(c*outputRows+blockBegin)*sizeof(double));
+          os.write(reinterpret_cast<const char*>(&block[c*n]), n*sizeof(double));
+        }
+    };
+  }
+  else {
+    // the rows of a block are formatted by several threads (each into its own buffer) and written in order
+    auto formatRows=[&](unsigned int begin, unsigned int end, string &o) {
+      o.clear();
+      for(unsigned int j=begin; j<end; j++) {
+        unsigned int row=first+j*stride;
+        for(unsigned int k=0; k<arg.size(); k++) {
+          // Output mynan for to short datasets
+          if(!reader[k] || row>=reader[k]->getRows()) {
+            for(unsigned int i=0; i<column[k].size(); i++) {
+              if(k>0 || i>0) o+=delim;
+              o+=mynan;
+            }
+            continue;
+          }
+
+          if(k>0) o+=delim;
+          reader[k]->printRow(o, row);
+        }
+        o+='\n';
       }
-      
-      cout<<(k==0?"":delim);
-      printRow(dataSet[k], row);
+    };
+    writeBlock=[&, formatRows](unsigned int blockBegin, unsigned int blockEnd) {
+      // use at most one thread per 1000 rows
+      unsigned int nt=max(1u, min<unsigned int>(threads, (blockEnd-blockBegin)/1000));
+      if(nt==1)
+        formatRows(blockBegin, blockEnd, out[0]);
+      else {
+        vector<thread> worker;
+        for(unsigned int t=0; t<nt; ++t)
+          worker.emplace_back(formatRows, blockBegin+(blockEnd-blockBegin)*t/nt, blockBegin+(blockEnd-blockBegin)*(t+1)/nt,
+                              ref(out[t]));
+        for(auto &t : worker)
+          t.join();
+      }
+      for(unsigned int t=0; t<nt; ++t)
+        os.write(out[t].data(), out[t].size());
+    };
+  }
+
+  // output the selected rows [begin, end[ (index of the selected rows)
+  auto dumpRows=[&](unsigned int begin, unsigned int end) {
+    for(unsigned int blockBegin=begin; blockBegin<end; blockBegin+=blockRows) {
+      unsigned int blockEnd=min(end, blockBegin+blockRows);
+      for(auto &r : reader)
+        if(r)
+          r->read(first+blockBegin*stride, blockEnd-blockBegin, stride);
+      writeBlock(blockBegin, blockEnd);
+    }
+    os.flush();
+  };
+  dumpRows(0, outputRows);
+
+  // follow mode: poll the files and output the appended rows, until the program is terminated
+  while(follow) {
+    this_thread::sleep_for(chrono::duration<double>(interval));
+    for(auto &f : file)
+      f->requestWriterFlush();
+    for(auto &f : file) {
+      f->waitForWriterFlush();
+      f->refresh();
+    }
+    for(auto &r : reader)
+      if(r)
+        r->refresh();
+    // the end of the time window may have been appended now (its begin has already been output)
+    if(timeWindow) {
+      unsigned int oldFirst=first;
+      timeWindowRows();
+      first=oldFirst;
+    }
+    unsigned int newOutputRows=selectedRows(availableRows());
+    if(newOutputRows>outputRows) {
+      dumpRows(outputRows, newOutputRows);
+      outputRows=newOutputRows;
     }
-    cout<<endl;
   }
 
+  if(binary=="arrow")
+    writeArrowEndOfStream(os);
+  os.flush();
+
   return 0;
 }
 
@@ -280,41 +728,3 @@ string quoteString(hid_t type) {
     return quote;
   return "";
 }
-
-void printRow(Dataset *d, int row) {
-# define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
-  { \
-    VectorSerie<CTYPE> *dd=dynamic_cast<VectorSerie<CTYPE>*>(d); \
-    if(dd) { \
-      vector<CTYPE> vec(dd->getColumns()); \
-      dd->getRow(row, vec); \
-      for(size_t i=0; i<vec.size(); ++i) \
-        cout<<(i==0?"":delim)<<quoteString(H5TYPE)<<vec[i]<<quoteString(H5TYPE); \
-    } \
-  }
-# include "hdf5serie/knowntypes.def"
-# undef FOREACHKNOWNTYPE
-
-# define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
-  { \
-    SimpleDataset<vector<CTYPE> > *dd=dynamic_cast<SimpleDataset<vector<CTYPE> >*>(d); \
-    if(dd) { \
-      vector<CTYPE> vec=dd->read(); \
-      cout<<quoteString(H5TYPE)<<vec[row]<<quoteString(H5TYPE); \
-    } \
-  }
-# include "hdf5serie/knowntypes.def"
-# undef FOREACHKNOWNTYPE
-
-# define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
-  { \
-    SimpleDataset<vector<vector<CTYPE> > > *dd=dynamic_cast<SimpleDataset<vector<vector<CTYPE> > >*>(d); \
-    if(dd) { \
-      vector<vector<CTYPE> > mat=dd->read(); \
-      for(size_t i=0; i<mat[0].size(); ++i) \
-        cout<<(i==0?"":delim)<<quoteString(H5TYPE)<<mat[row][i]<<quoteString(H5TYPE); \
-    } \
-  }
-# include "hdf5serie/knowntypes.def"
-# undef FOREACHKNOWNTYPE
-}
@@ -22,14 +22,152 @@
 #include <config.h>
 #include <cassert>
 #include <cfenv>
+#include <cstring>
 #include <iostream>
+#include <sstream>
+#include <map>
+#include <memory>
 #include <hdf5serie/file.h>
 #include <boost/filesystem.hpp>
+#ifndef _WIN32
+#  include <csignal>
+#  include <unistd.h>
+#  include <poll.h>
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#endif
 
 using namespace std;
 using namespace H5;
 using namespace boost::filesystem;
 
+namespace {
+
+// the flush clients of all files requested so far (the interprocess elements stay attached)
+map<string, unique_ptr<WriterFlushClient> > client;
+int waitTime=1000/25;
+
+// the wait time in milliseconds given by value (of the option or environment variable name)
+int parseWaitTime(const string &value, const string &name) {
+  size_t pos=0;
+  int msec=-1;
+  try { msec=stoi(value, &pos); } catch(const exception &) {}
+  if(msec<0 || pos!=value.size())
+    throw runtime_error("Invalid wait time "+value+" of "+name+".");
+  return msec;
+}
+
+// Process a request line of the daemon mode: all files of the line are flushed.
+// Returns the response line: for each file the refresh flag (0 or 1) and the flush latency in microseconds (-1 if
+// the file was not flushed).
+string processRequest(const string &line) {
+  vector<WriterFlushClient*> files;
+  istringstream str(line);
+  string filename;
+  while(str>>filename) {
+    auto &c=client[filename];
+    if(!c)
+      c=make_unique<WriterFlushClient>(filename);
+    files.emplace_back(c.get());
+  }
+  // request all flushes first, then wait for all
+  for(auto *f : files)
+    f->requestFlush();
+  string ret;
+  for(auto *f : files) {
+    long latency=f->waitForFlush(waitTime);
+    ret+=(ret.empty()?"":" ")+string(latency>=0 ? "1 " : "0 ")+to_string(latency);
+  }
+  return ret;
+}
+
+void serveStdin() {
+  string line;
+  while(getline(cin, line) && line!="quit")
+    cout<<processRequest(line)<<endl;
+}
+
+#ifndef _WIN32
+volatile sig_atomic_t stop=0;
+
+void stopHandler(int) {
+  stop=1;
+}
+
+// serve all clients connecting to the local socket socketPath (until SIGINT/SIGTERM)
+void serveSocket(const string &socketPath) {
+  int server=socket(AF_UNIX, SOCK_STREAM, 0);
+  if(server<0)
+    throw runtime_error("Cannot create a socket.");
+  sockaddr_un addr {};
+  addr.sun_family=AF_UNIX;
+  if(socketPath.size()>=sizeof(addr.sun_path))
+    throw runtime_error("The socket path is too long.");
+  strcpy(addr.sun_path, socketPath.c_str());
+  unlink(socketPath.c_str());
+  if(bind(server, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))!=0 || listen(server, 16)!=0)
+    throw runtime_error("Cannot listen on socket "+socketPath+".");
+  // close all sockets and remove the socket file on exit (also on a exception)
+  vector<pollfd> fds { { server, POLLIN, 0 } };
+  struct Cleanup {
+    const string &socketPath;
+    vector<pollfd> &fds;
+    ~Cleanup() {
+      for(auto &fd : fds)
+        close(fd.fd);
+      unlink(socketPath.c_str());
+    }
+  } cleanup { socketPath, fds };
+  // stop on SIGINT/SIGTERM: poll is interrupted (no SA_RESTART)
+  struct sigaction sa {};
+  sa.sa_handler=&stopHandler;
+  sigaction(SIGINT, &sa, nullptr);
+  sigaction(SIGTERM, &sa, nullptr);
+
+  vector<string> buffer(1); // the unprocessed input of each client (index as in fds)
+  while(!stop) {
+    if(poll(fds.data(), fds.size(), -1)<0)
+      continue;
+    if(fds[0].revents & POLLIN) {
+      int c=accept(server, nullptr, nullptr);
+      if(c>=0) {
+        fds.push_back({ c, POLLIN, 0 });
+        buffer.emplace_back();
+      }
+    }
+    for(size_t i=fds.size()-1; i>0; --i) {
+      if(!fds[i].revents)
+        continue;
+      char buf[4096];
+      ssize_t n=read(fds[i].fd, buf, sizeof(buf));
+      bool closeClient=n<=0;
+      if(n>0)
+        buffer[i].append(buf, n);
+      size_t pos;
+      while(!closeClient && (pos=buffer[i].find('\n'))!=string::npos) {
+        string line=buffer[i].substr(0, pos);
+        buffer[i].erase(0, pos+1);
+        if(line=="quit") {
+          closeClient=true;
+          break;
+        }
+        // a client may have disconnected (e.g. after its own timeout): no SIGPIPE, just close this client
+        string response=processRequest(line)+"\n";
+        if(send(fds[i].fd, response.data(), response.size(), MSG_NOSIGNAL)!=static_cast<ssize_t>(response.size()))
+          closeClient=true;
+      }
+      if(closeClient) {
+        close(fds[i].fd);
+        fds.erase(fds.begin()+i);
+        buffer.erase(buffer.begin()+i);
+      }
+    }
+  }
+}
+#endif
+
+}
+
 int main(int argc, char *argv[]) {
 #ifndef _WIN32
   assert(feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW)!=-1);
@@ -38,12 +176,46 @@ int main(int argc, char *argv[]) {
   try {
     if(argc==1 || (argc==2 && argv[1]==string("-h"))) {
       cout<<"Usage: "<<argv[0]<<" [-h| <file> ...]"<<endl;
+      cout<<"       "<<argv[0]<<" -d [-w <msec>]"<<endl;
+#ifndef _WIN32
+      cout<<"       "<<argv[0]<<" -s <socket> [-w <msec>]"<<endl;
+#endif
       cout<<endl;
       cout<<"Flush all HDF5Serie files given as arguments."<<endl;
       cout<<"Waits until all files are flushed successfully or a timeout occures."<<endl;
       cout<<"Outputs for each file provided as argument, in order, 0 or 1:"<<endl;
       cout<<"0 = no refresh of this file needed, since the flush was not successfull or no new data are available"<<endl;
       cout<<"1 = refresh this file, since new data is available"<<endl;
+      cout<<endl;
+      cout<<"-d: Daemon mode: read requests from stdin, one per line, until EOF or a line \"quit\"."<<endl;
+#ifndef _WIN32
+      cout<<"-s: Daemon mode: read requests from clients connecting to the local (unix domain) socket <socket>."<<endl;
+#endif
+      cout<<"    A request is a line of space separated files to flush. The response is a line with two values per"<<endl;
+      cout<<"    file, in order: the refresh flag (0 or 1, see above) and the flush latency in microseconds (-1 if not"<<endl;
+      cout<<"    flushed). The files are not opened, only the interprocess elements of their writers are attached,"<<endl;
+      cout<<"    and stay attached between requests."<<endl;
+      cout<<"-w: Wait at most <msec> milliseconds for each flush (default: $HDF5SERIE_REFRESHWAITTIME or 40)."<<endl;
+      return 0;
+    }
+
+    if(argv[1]==string("-d") || argv[1]==string("-s")) {
+      if(getenv("HDF5SERIE_REFRESHWAITTIME"))
+        waitTime=parseWaitTime(getenv("HDF5SERIE_REFRESHWAITTIME"), "HDF5SERIE_REFRESHWAITTIME");
+      string socketPath;
+      for(int i=1; i<argc; ++i) {
+        if(argv[i]==string("-w") && i+1<argc)
+          waitTime=parseWaitTime(argv[++i], "-w");
+        else if(argv[i]==string("-s") && i+1<argc)
+          socketPath=argv[++i];
+      }
+#ifndef _WIN32
+      if(!socketPath.empty()) {
+        serveSocket(socketPath);
+        return 0;
+      }
+#endif
+      serveStdin();
       return 0;
     }
 
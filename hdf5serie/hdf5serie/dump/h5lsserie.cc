@@ -23,33 +23,57 @@
 #include <cassert>
 #include <cfenv>
 #include <iostream>
+#include <sstream>
 #include <cstring>
 #include <fstream>
+#include <deque>
+#include <functional>
 #include <hdf5serie/file.h>
 #include <hdf5serie/simpleattribute.h>
 #include <boost/filesystem.hpp>
+#include "datasetinfo.h"
+#ifndef _WIN32
+#  include <unistd.h>
+#  include <sys/wait.h>
+#endif
 
 using namespace std;
 using namespace H5;
 using namespace boost::filesystem;
 
-void walkH5(const string &indent, const path &filename, const string &path, GroupBase *obj);
+void walkH5(ostream &os, const string &indent, const path &filename, const string &path, GroupBase *obj);
+void walkMetadata(ostream &os, vector<string> &objects, const string &indent, const path &filename, const string &path, GroupBase *obj);
+string listFile(const string &filename);
+int runJobs(const vector<string> &files, int jobs, const function<string(const string&)> &list, const function<void(const string&)> &output);
 void printhelp();
-void printDesc(const string& indent, Object *obj);
-void printLabel(const string& indent, Dataset *d);
+void printDesc(ostream &os, const string& indent, Object *obj);
+void printLabel(ostream &os, const string& indent, Dataset *d);
 
-bool d=false, l=false, f=false, h=false;
+bool d=false, l=false, f=false, h=false, m=false, json=false;
 
 int main(int argc, char *argv[]) {
 #ifndef _WIN32
   assert(feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW)!=-1);
 #endif
 
+  int jobs=1;
+  vector<string> files;
   for(int i=1; i<argc; i++) {
     if(strcmp(argv[i], "-d")==0) d=true;
-    if(strcmp(argv[i], "-l")==0) l=true;
-    if(strcmp(argv[i], "-f")==0) f=true;
-    if(strcmp(argv[i], "-h")==0 || strcmp(argv[i], "--help")==0) h=true;
+    else if(strcmp(argv[i], "-l")==0) l=true;
+    else if(strcmp(argv[i], "-f")==0) f=true;
+    else if(strcmp(argv[i], "-m")==0) m=true;
+    else if(strcmp(argv[i], "--json")==0) json=m=true;
+    else if(strcmp(argv[i], "-j")==0 && i+1<argc) jobs=max(1, atoi(argv[++i]));
+    else if(strcmp(argv[i], "-h")==0 || strcmp(argv[i], "--help")==0) h=true;
+    else {
+      string filename=argv[i];
+      std::ifstream f(filename.c_str());
+      bool good=f.good();
+      f.close();
+      if(good)
+        files.emplace_back(filename);
+    }
   }
 
   if(h || argc<=1) {
@@ -57,27 +81,142 @@ int main(int argc, char *argv[]) {
     return 0;
   }
 
-  for(int i=1; i<argc; i++) {
-    string filename=argv[i];
-    std::ifstream f(filename.c_str());
-    bool good=f.good();
-    f.close();
-    if(good)
-    {
-      File file(filename, File::read);
-      walkH5("", filename, "", &file);
+  bool first=true;
+  if(json) cout<<"["<<endl;
+  int ret=runJobs(files, jobs, &listFile, [&first](const string &out) {
+    if(json && !first) cout<<","<<endl;
+    first=false;
+    cout<<out<<flush;
+  });
+  if(json) cout<<(first?"":"\n")<<"]"<<endl;
+
+  return ret;
+}
+
+// quote and escape str as JSON string
+string jsonString(const string &str) {
+  string ret("\"");
+  for(char c : str) {
+    if(c=='"' || c=='\\') { ret+='\\'; ret+=c; }
+    else if(c=='\n') ret+="\\n";
+    else if(c=='\t') ret+="\\t";
+    else if(static_cast<unsigned char>(c)<0x20) {
+      char buf[7];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      ret+=buf;
+    }
+    else ret+=c;
+  }
+  return ret+"\"";
+}
+
+template<class T>
+string jsonArray(const vector<T> &v, const function<string(const T&)> &conv) {
+  string ret("[");
+  for(size_t i=0; i<v.size(); ++i)
+    ret+=(i==0?"":",")+conv(v[i]);
+  return ret+"]";
+}
+
+string listFile(const string &filename) {
+  ostringstream os;
+  File file(filename, File::read);
+  if(!m)
+    walkH5(os, "", filename, "", &file);
+  else {
+    vector<string> objects;
+    walkMetadata(os, objects, "", filename, "", &file);
+    if(json) {
+      os<<"{\"file\":"<<jsonString(filename)<<",\"objects\":[";
+      for(size_t i=0; i<objects.size(); ++i)
+        os<<(i==0?"\n  ":",\n  ")<<objects[i];
+      os<<(objects.empty()?"":"\n")<<"]}";
     }
   }
+  return os.str();
+}
 
-  return 0;
+// Run list for all files and pass the result to output, in the order of files.
+// Up to jobs files are listed at the same time. The HDF5 library is not thread-safe in general, hence each file is
+// listed in a child process which sends its complete output through a pipe to this process.
+int runJobs(const vector<string> &files, int jobs, const function<string(const string&)> &list, const function<void(const string&)> &output) {
+  int ret=0;
+#ifndef _WIN32
+  if(jobs>1 && files.size()>1) {
+    struct Job { pid_t pid; int fd; };
+    deque<Job> running;
+    size_t next=0;
+    auto start=[&files, &list, &running](size_t i) {
+      int fd[2];
+      if(pipe(fd)!=0)
+        throw runtime_error("Cannot create a pipe.");
+      cout.flush();
+      pid_t pid=fork();
+      if(pid<0)
+        throw runtime_error("Cannot fork a child process.");
+      if(pid==0) {
+        close(fd[0]);
+        int exitCode=0;
+        string out;
+        try {
+          out=list(files[i]);
+        }
+        catch(const exception &ex) {
+          cerr<<ex.what()<<endl;
+          exitCode=1;
+        }
+        for(size_t written=0; written<out.size();) {
+          ssize_t n=write(fd[1], out.data()+written, out.size()-written);
+          if(n<=0) { exitCode=1; break; }
+          written+=n;
+        }
+        close(fd[1]);
+        _exit(exitCode);
+      }
+      close(fd[1]);
+      running.push_back({pid, fd[0]});
+    };
+    for(; next<min<size_t>(jobs, files.size()); ++next)
+      start(next);
+    while(!running.empty()) {
+      Job job=running.front();
+      running.pop_front();
+      string out;
+      char buf[65536];
+      ssize_t n;
+      while((n=read(job.fd, buf, sizeof(buf)))>0)
+        out.append(buf, n);
+      close(job.fd);
+      int status;
+      waitpid(job.pid, &status, 0);
+      if(!WIFEXITED(status) || WEXITSTATUS(status)!=0)
+        ret=1;
+      else
+        output(out);
+      if(next<files.size())
+        start(next++);
+    }
+    return ret;
+  }
+#endif
+  for(const auto &file : files) {
+    try {
+      output(list(file));
+    }
+    catch(const exception &ex) {
+      cerr<<ex.what()<<endl;
+      ret=1;
+    }
+  }
+  return ret;
 }
 
-void walkH5(const string &indent, const path &filename, const string &path, GroupBase *obj) {
+void walkH5(ostream &os, const string &indent, const path &filename, const string &path, GroupBase *obj) {
   set<string> names=obj->getChildObjectNames();
   for(const auto& name : names) {
     if(obj->isExternalLink(name) && !f) {
       pair<boost::filesystem::path, string> link=obj->getExternalLink(name);
-      cout<<indent<<"* "<<name<<" (External Link: \""<<link.first.string()<<link.second<<"\")"<<endl;
+      os<<indent<<"* "<<name<<" (External Link: \""<<link.first.string()<<link.second<<"\")"<<endl;
       continue;
     }
 
@@ -86,20 +225,103 @@ void walkH5(const string &indent, const path &filename, const string &path, Grou
     auto *g=dynamic_cast<Group*>(child);
     if(g) {
       // print and walk
-      cout<<indent<<"+ "<<name<<endl;
-      printDesc(indent, g);
-      walkH5(indent+"  ", filename, path+"/"+name, g);
+      os<<indent<<"+ "<<name<<endl;
+      printDesc(os, indent, g);
+      walkH5(os, indent+"  ", filename, path+"/"+name, g);
       continue;
     }
 
     auto *d=dynamic_cast<Dataset*>(child);
     if(d) {
       // print
-      cout<<indent<<"- "<<name<<" (Path: \""<<filename.string()<<path<<"/"<<name<<"\")"<<endl;
-      printLabel(indent, d);
-      printDesc(indent, d);
+      os<<indent<<"- "<<name<<" (Path: \""<<filename.string()<<path<<"/"<<name<<"\")"<<endl;
+      printLabel(os, indent, d);
+      printDesc(os, indent, d);
+      continue;
+    }
+  }
+}
+
+// Print the metadata of a dataset without opening it as a hdf5serie object (no VectorSerie, ... is instantiated).
+// Only the HDF5 object header is read, no raw data.
+void printDatasetMetadata(ostream &os, vector<string> &objects, const string &indent, const path &filename, const string &path,
+                          hid_t dataset) {
+  DatasetInfo info=getDatasetInfo(dataset);
+  vector<string> desc, label;
+  if(d) desc=readStringAttribute(dataset, "Description");
+  if(l) label=readStringAttribute(dataset, "Column Label");
+
+  if(json) {
+    function<string(const hsize_t&)> dimConv=[](const hsize_t &v) { return v==H5S_UNLIMITED ? string("-1") : to_string(v); };
+    function<string(const unsigned&)> paramConv=[](const unsigned &v) { return to_string(v); };
+    function<string(const FilterInfo&)> filterConv=[&paramConv](const FilterInfo &f) {
+      return "{\"name\":"+jsonString(f.name)+",\"parameters\":"+jsonArray(f.param, paramConv)+"}";
+    };
+    string obj="{\"path\":"+jsonString(path)+",\"type\":\"dataset\",\"datatype\":"+jsonString(info.datatype)+
+      ",\"dims\":"+jsonArray(info.dims, dimConv)+",\"maxDims\":"+jsonArray(info.maxDims, dimConv)+
+      ",\"chunk\":"+(info.chunk.empty() ? string("null") : jsonArray(info.chunk, dimConv))+
+      ",\"filters\":"+jsonArray(info.filters, filterConv)+",\"compression\":"+to_string(info.compression)+
+      ",\"storageSize\":"+to_string(info.storageSize);
+    if(!desc.empty())
+      obj+=",\"description\":"+jsonString(desc[0]);
+    if(!label.empty())
+      obj+=",\"columnLabel\":"+jsonArray(label, function<string(const string&)>(&jsonString));
+    objects.emplace_back(obj+"}");
+    return;
+  }
+  os<<indent<<"- "<<path.substr(path.rfind('/')+1)<<" (Path: \""<<filename.string()<<path<<"\")"<<endl;
+  os<<indent<<"  "<<info.datatype<<", "<<dimString(info.dims)<<" (max "<<dimString(info.maxDims)<<")";
+  if(!info.chunk.empty())
+    os<<", chunk "<<dimString(info.chunk);
+  for(auto &f : info.filters)
+    os<<", "<<f.name<<(f.name=="deflate" && !f.param.empty() ? "("+to_string(f.param[0])+")" : "");
+  os<<", "<<info.storageSize<<" bytes"<<endl;
+  if(!label.empty()) {
+    os<<indent<<"  Column Label: ";
+    for(size_t i=0; i<label.size(); i++)
+      os<<"\""<<label[i]<<"\""<<(i!=label.size()-1?",":"")<<" ";
+    os<<endl;
+  }
+  if(!desc.empty())
+    os<<indent<<"  Description: \""<<desc[0]<<"\""<<endl;
+}
+
+void walkMetadata(ostream &os, vector<string> &objects, const string &indent, const path &filename, const string &path, GroupBase *obj) {
+  set<string> names=obj->getChildObjectNames();
+  for(const auto& name : names) {
+    if(obj->isExternalLink(name) && !f) {
+      pair<boost::filesystem::path, string> link=obj->getExternalLink(name);
+      if(json)
+        objects.emplace_back("{\"path\":"+jsonString(path+"/"+name)+",\"type\":\"externalLink\",\"target\":"+
+                          jsonString(link.first.string()+link.second)+"}");
+      else
+        os<<indent<<"* "<<name<<" (External Link: \""<<link.first.string()<<link.second<<"\")"<<endl;
       continue;
     }
+
+    // get the object type from the HDF5 object header
+    ScopedHID o(H5Oopen(obj->getID(), name.c_str(), H5P_DEFAULT), &H5Oclose);
+    H5I_type_t type=H5Iget_type(o);
+
+    if(type==H5I_GROUP) {
+      // groups are cheap: use the hdf5serie object to walk (handles external links)
+      auto *g=obj->openChildObject<Group>(name);
+      if(json) {
+        string entry="{\"path\":"+jsonString(path+"/"+name)+",\"type\":\"group\"";
+        vector<string> desc;
+        if(d) desc=readStringAttribute(o, "Description");
+        objects.emplace_back(entry+(desc.empty() ? "" : ",\"description\":"+jsonString(desc[0]))+"}");
+      }
+      else {
+        os<<indent<<"+ "<<name<<endl;
+        printDesc(os, indent, g);
+      }
+      walkMetadata(os, objects, indent+"  ", filename, path+"/"+name, g);
+      continue;
+    }
+
+    if(type==H5I_DATASET)
+      printDatasetMetadata(os, objects, indent, filename, path+"/"+name, o);
   }
 }
 
@@ -116,30 +338,36 @@ cout<<
 "Licensed under the GNU Lesser General Public License (LGPL)"<<endl<<
 ""<<endl<<
 "Usage:"<<endl<<
-"  h5lsserie [-d] [-l] [-f] [-h|--help] <file.h5> ..."<<endl<<
+"  h5lsserie [-d] [-l] [-f] [-m] [--json] [-j <n>] [-h|--help] <file.h5> ..."<<endl<<
 "    -h, --help: Show this help"<<endl<<
 "    -d:         Show 'Description' attribute"<<endl<<
 "    -l:         Show 'Column/Member Label'"<<endl<<
-"    -f:         Follow external links"<<endl;
+"    -f:         Follow external links"<<endl<<
+"    -m:         Metadata only: show datatype, dimensions, chunking, filters"<<endl<<
+"                and storage size of each dataset (datasets are not opened as"<<endl<<
+"                hdf5serie objects, no data is read)"<<endl<<
+"    --json:     Like -m but print the result as JSON: a array with one"<<endl<<
+"                object per file {\"file\":..., \"objects\":[...]}"<<endl<<
+"    -j <n>:     List up to <n> files concurrently (in child processes)"<<endl;
 }
 
-void printDesc(const string& indent, Object *obj) {
+void printDesc(ostream &os, const string& indent, Object *obj) {
   if(!d) return;
 
   if(obj->hasChildAttribute("Description")) {
     string ret=obj->openChildAttribute<SimpleAttribute<string> >("Description")->read();
-    cout<<indent<<"  Description: \""<<ret<<"\""<<endl;
+    os<<indent<<"  Description: \""<<ret<<"\""<<endl;
   }
 }
 
-void printLabel(const string& indent, Dataset *d) {
+void printLabel(ostream &os, const string& indent, Dataset *d) {
   if(!l) return;
 
   if(d->hasChildAttribute("Column Label")) {
     vector<string> ret=d->openChildAttribute<SimpleAttribute<vector<string> > >("Column Label")->read();
-    cout<<indent<<"  Column Label: ";
+    os<<indent<<"  Column Label: ";
     for(size_t i=0; i<ret.size(); i++)
-      cout<<"\""<<ret[i]<<"\""<<(i!=ret.size()-1?",":"")<<" ";
-    cout<<endl;
+      os<<"\""<<ret[i]<<"\""<<(i!=ret.size()-1?",":"")<<" ";
+    os<<endl;
   }
 }
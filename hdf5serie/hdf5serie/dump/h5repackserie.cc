@@ -0,0 +1,309 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include <cassert>
+#include <cfenv>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <hdf5serie/file.h>
+#include <hdf5serie/vectorserie.h>
+#include <hdf5serie/simpledataset.h>
+#include <boost/filesystem.hpp>
+#include "datasetinfo.h"
+
+using namespace std;
+using namespace H5;
+
+namespace {
+
+// the options of the target datasets (unset = as in the source dataset)
+optional<int> chunkSize;           // rows per chunk (0 = auto)
+optional<int> columnsPerChunk;
+optional<int> compression;
+optional<bool> predictiveFilter;
+double relativeError=0, absoluteError=0;
+bool pyramid=false, timeIndex=false, zoneMap=false;
+size_t memoryBytes=64*1024*1024;   // memory used for the data of a dataset while copying
+const size_t autoChunkBytes=64*1024;
+bool verbose=false;
+
+const string predictiveFilterName("hdf5serie predictive filter");
+
+struct CopyAttributesData {
+  hid_t dst;
+  optional<string> error;
+};
+
+herr_t copyAttributeCB(hid_t src, const char *name, const H5A_info_t *, void *data) {
+  auto &d=*static_cast<CopyAttributesData*>(data);
+  try {
+    if(H5Aexists(d.dst, name)>0)
+      return 0;
+    ScopedHID a(H5Aopen(src, name, H5P_DEFAULT), &H5Aclose);
+    ScopedHID type(H5Aget_type(a), &H5Tclose);
+    ScopedHID memType(H5Tget_native_type(type, H5T_DIR_ASCEND), &H5Tclose);
+    ScopedHID space(H5Aget_space(a), &H5Sclose);
+    vector<char> buf(H5Sget_simple_extent_npoints(space)*H5Tget_size(memType));
+    H5Aread(a, memType, buf.data());
+    ScopedHID b(H5Acreate2(d.dst, name, type, space, H5P_DEFAULT, H5P_DEFAULT), &H5Aclose);
+    H5Awrite(b, memType, buf.data());
+    if(H5Tis_variable_str(memType)>0 || H5Tdetect_class(memType, H5T_VLEN)>0)
+      H5Dvlen_reclaim(memType, space, H5P_DEFAULT, buf.data());
+    return 0;
+  }
+  catch(const exception &ex) {
+    d.error=string("Cannot copy attribute ")+name+": "+ex.what();
+    return -1;
+  }
+}
+
+// copy all attributes of the HDF5 object src to dst (attributes already existing in dst, e.g. created by the
+// library, are kept)
+void copyAttributes(hid_t src, hid_t dst) {
+  CopyAttributesData data { dst, {} };
+  hsize_t idx=0;
+  H5Aiterate2(src, H5_INDEX_NAME, H5_ITER_NATIVE, &idx, &copyAttributeCB, &data);
+  if(data.error)
+    throw runtime_error(*data.error);
+}
+
+template<class T>
+void copyVectorSerie(VectorSerie<T> *src, GroupBase *dstParent, const string &name) {
+  constexpr bool isString=is_same_v<T, string>;
+  DatasetInfo info=getDatasetInfo(src->getID());
+  int cols=src->getColumns();
+  int rows=src->getRows();
+
+  // the options of the target dataset
+  VectorSerieOptions opt;
+  opt.compression=compression ? *compression : info.compression;
+  opt.columnsPerChunk=columnsPerChunk ? *columnsPerChunk : (info.chunk.size()==2 && static_cast<int>(info.chunk[1])<cols ? info.chunk[1] : 0);
+  size_t chunkCols=opt.columnsPerChunk>0 && opt.columnsPerChunk<cols ? opt.columnsPerChunk : cols;
+  size_t elementBytes=isString ? 32 : sizeof(T); // rough estimate for strings
+  if(chunkSize)
+    opt.chunkSize=*chunkSize>0 ? *chunkSize : max<size_t>(1, autoChunkBytes/(chunkCols*elementBytes));
+  else if(info.chunk.size()==2)
+    opt.chunkSize=info.chunk[0];
+  bool srcPredict=false;
+  for(auto &f : info.filters)
+    if(f.name==predictiveFilterName) {
+      srcPredict=true;
+      // keep the prediction modes per column of the source (if they repeat with the columns per chunk of the target)
+      if(f.param.size()>4) {
+        size_t srcChunkCols=f.param.size()-4;
+        for(int c=0; c<cols; ++c)
+          opt.predictModes.push_back(static_cast<PredictMode>(f.param[4+c%srcChunkCols]));
+        for(int c=chunkCols; c<cols; ++c)
+          if(opt.predictModes[c]!=opt.predictModes[c%chunkCols]) {
+            cerr<<"Warning: the prediction modes of "<<src->getPath()<<" do not fit to the new chunk layout, using the default modes."<<endl;
+            opt.predictModes.clear();
+            break;
+          }
+      }
+    }
+  opt.predictiveFilter=predictiveFilter ? *predictiveFilter : srcPredict;
+  if constexpr (is_same_v<T, double> || is_same_v<T, float>) {
+    opt.relativeError=relativeError;
+    opt.absoluteError=absoluteError;
+  }
+
+  auto *dst=dstParent->createChildObject<VectorSerie<T> >(name)(cols, opt);
+  copyAttributes(src->getID(), dst->getID());
+  if constexpr (!isString) {
+    // indexes of the source are recreated with the parameters of the source (new ones with the default parameters)
+    if(src->hasPyramid())
+      dst->enablePyramid(src->getPyramidFactor(), src->getPyramidLevels());
+    else if(pyramid)
+      dst->enablePyramid();
+    if(src->hasTimeIndex())
+      dst->enableTimeIndex(src->getTimeIndexColumn());
+    else if(timeIndex)
+      dst->enableTimeIndex();
+    if(zoneMap || src->hasZoneMap())
+      dst->enableZoneMap();
+    // compress complete chunks with the worker threads
+    if(chunkCols==static_cast<size_t>(cols))
+      dst->enableDirectChunkWrite();
+  }
+
+  // stream the rows in blocks of (a multiple of) whole chunks
+  int blockRows=max<size_t>(1, memoryBytes/(cols*elementBytes));
+  if(opt.chunkSize>0 && blockRows>opt.chunkSize) // a chunk has at least one row; guard the modulo anyway
+    blockRows-=blockRows%opt.chunkSize;
+  vector<T> block;
+  for(int start=0; start<rows; start+=blockRows) {
+    int count=min(blockRows, rows-start);
+    block.resize(static_cast<size_t>(count)*cols);
+    src->getRowRange(start, count, block.size(), block.data());
+    for(int r=0; r<count; ++r)
+      dst->append(block.data()+static_cast<size_t>(r)*cols, cols);
+  }
+  if(verbose)
+    cout<<dst->getPath()<<": "<<rows<<" x "<<cols<<", chunk "<<opt.chunkSize<<" x "<<chunkCols<<endl;
+}
+
+template<class T>
+void copySimpleDataset(SimpleDataset<T> *src, GroupBase *dstParent, const string &name) {
+  auto *dst=dstParent->createChildObject<SimpleDataset<T> >(name)();
+  dst->write(src->read());
+  copyAttributes(src->getID(), dst->getID());
+}
+
+template<class T>
+void copySimpleDataset(SimpleDataset<vector<T> > *src, GroupBase *dstParent, const string &name) {
+  vector<T> data=src->read();
+  auto *dst=dstParent->createChildObject<SimpleDataset<vector<T> > >(name)(data.size());
+  dst->write(data);
+  copyAttributes(src->getID(), dst->getID());
+}
+
+template<class T>
+void copySimpleDataset(SimpleDataset<vector<vector<T> > > *src, GroupBase *dstParent, const string &name) {
+  vector<vector<T> > data=src->read();
+  auto *dst=dstParent->createChildObject<SimpleDataset<vector<vector<T> > > >(name)(data.size(), data.empty() ? 0 : data[0].size());
+  dst->write(data);
+  copyAttributes(src->getID(), dst->getID());
+}
+
+void copyGroup(GroupBase *src, GroupBase *dst) {
+  copyAttributes(src->getID(), dst->getID());
+  for(const auto &name : src->getChildObjectNames()) {
+    if(src->isExternalLink(name)) {
+      // copy the link as it is (the linked file is not copied)
+      H5L_info_t link;
+      H5Lget_info(src->getID(), name.c_str(), &link, H5P_DEFAULT);
+      vector<char> buf(link.u.val_size);
+      H5Lget_val(src->getID(), name.c_str(), buf.data(), buf.size(), H5P_DEFAULT);
+      const char *file, *obj;
+      H5Lunpack_elink_val(buf.data(), buf.size(), nullptr, &file, &obj);
+      H5Lcreate_external(file, obj, dst->getID(), name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+      continue;
+    }
+
+    Object *child=src->openChildObject(name);
+    if(auto *g=dynamic_cast<Group*>(child)) {
+      copyGroup(g, dst->createChildObject<Group>(name)());
+      continue;
+    }
+#   define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
+    if(auto *d=dynamic_cast<VectorSerie<CTYPE>*>(child)) { copyVectorSerie(d, dst, name); continue; } \
+    if(auto *d=dynamic_cast<SimpleDataset<CTYPE>*>(child)) { copySimpleDataset(d, dst, name); continue; } \
+    if(auto *d=dynamic_cast<SimpleDataset<vector<CTYPE> >*>(child)) { copySimpleDataset(d, dst, name); continue; } \
+    if(auto *d=dynamic_cast<SimpleDataset<vector<vector<CTYPE> > >*>(child)) { copySimpleDataset(d, dst, name); continue; }
+#   include "hdf5serie/knowntypes.def"
+#   undef FOREACHKNOWNTYPE
+    throw runtime_error("Cannot copy "+child->getPath()+": unknown dataset type.");
+  }
+}
+
+void printhelp() {
+cout<<
+"h5repackserie"<<endl<<
+""<<endl<<
+"Copies all groups, datasets and attributes of a hdf5serie file into a new"<<endl<<
+"file with a new chunk shape, filters and indexes."<<endl<<
+""<<endl<<
+"Copyright (C) 2026 Markus Friedrich <friedrich.at.gc@googlemail.com>"<<endl<<
+"This is free software; see the source for copying conditions. There is NO"<<endl<<
+"warranty; not even for MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE."<<endl<<
+""<<endl<<
+"Licensed under the GNU Lesser General Public License (LGPL)"<<endl<<
+""<<endl<<
+"Usage:"<<endl<<
+"  h5repackserie [options] <source.h5> <target.h5>"<<endl<<
+"    -h, --help:               Show this help"<<endl<<
+"    -v:                       Print each copied VectorSerie"<<endl<<
+"    --chunk <rows>|auto:      Rows per chunk (auto: about 64 KiB per chunk)"<<endl<<
+"    --columns-per-chunk <n>:  Column layout with n columns per chunk"<<endl<<
+"                              (0: row layout)"<<endl<<
+"    --compression <level>:    Deflate level (0: no compression)"<<endl<<
+"    --predict, --no-predict:  Enable/disable the predictive filter"<<endl<<
+"    --relative-error <e>:     Lossy storage of float/double data, see"<<endl<<
+"    --absolute-error <e>:     VectorSerieOptions"<<endl<<
+"    --pyramid:                Create a min/max/mean pyramid"<<endl<<
+"    --time-index:             Create a time index of column 0"<<endl<<
+"    --zone-map:               Create a zone map"<<endl<<
+"    -j <n>:                   Number of worker threads compressing and"<<endl<<
+"                              decompressing chunks"<<endl<<
+"    --memory <MiB>:           Memory used for the rows of a dataset while"<<endl<<
+"                              copying (default 64)"<<endl<<
+""<<endl<<
+"Options not given are taken from each source dataset. The options only apply"<<endl<<
+"to VectorSerie datasets; other datasets are copied as they are. Indexes"<<endl<<
+"existing in the source are recreated with the parameters of the source"<<endl<<
+"(pyramid factor and levels, time index column)."<<endl<<
+"External links are copied as links."<<endl;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+#ifndef _WIN32
+  assert(feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW)!=-1);
+#endif
+
+  vector<string> files;
+  try {
+    for(int i=1; i<argc; i++) {
+      string arg=argv[i];
+      auto value=[&i, argc, argv, &arg]() {
+        if(i+1>=argc)
+          throw runtime_error("Missing value of option "+arg+".");
+        return string(argv[++i]);
+      };
+      if(arg=="-h" || arg=="--help") {
+        printhelp();
+        return 0;
+      }
+      else if(arg=="-v") verbose=true;
+      else if(arg=="--chunk") { string v=value(); chunkSize=v=="auto" ? 0 : max(1, stoi(v)); }
+      else if(arg=="--columns-per-chunk") columnsPerChunk=max(0, stoi(value()));
+      else if(arg=="--compression") compression=stoi(value());
+      else if(arg=="--predict") predictiveFilter=true;
+      else if(arg=="--no-predict") predictiveFilter=false;
+      else if(arg=="--relative-error") relativeError=stod(value());
+      else if(arg=="--absolute-error") absoluteError=stod(value());
+      else if(arg=="--pyramid") pyramid=true;
+      else if(arg=="--time-index") timeIndex=true;
+      else if(arg=="--zone-map") zoneMap=true;
+      else if(arg=="-j") File::setNumberOfWorkerThreads(max(1, stoi(value())));
+      else if(arg=="--memory") memoryBytes=max(1, stoi(value()))*size_t(1024*1024);
+      else files.emplace_back(arg);
+    }
+    if(files.size()!=2) {
+      printhelp();
+      return 1;
+    }
+    if(boost::filesystem::exists(files[1]) && boost::filesystem::equivalent(files[0], files[1]))
+      throw runtime_error("The source and the target file must be different.");
+
+    File src(files[0], File::read);
+    File dst(files[1], File::write);
+    copyGroup(&src, &dst);
+  }
+  catch(const exception &ex) {
+    cerr<<ex.what()<<endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,334 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include <cassert>
+#include <cfenv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <hdf5serie/file.h>
+#include <hdf5serie/companiondataset.h>
+#include <boost/filesystem.hpp>
+#include "datasetinfo.h"
+
+using namespace std;
+using namespace H5;
+using namespace boost::filesystem;
+
+namespace {
+
+// statistics of one dataset
+struct DatasetStat {
+  string path;
+  bool companion { false };    // a companion dataset (index, pyramid) of the dataset reported before
+  DatasetInfo info;
+  hsize_t elements { 0 };      // number of elements of the dataset
+  hsize_t chunks { 0 };        // number of allocated chunks
+  hsize_t chunkElements { 0 }; // number of elements per chunk
+  double logicalSize { -1 };   // size of the uncompressed data (-1 if unknown = variable length type)
+  int idealChunkRows { 0 };    // number of rows per chunk for the target chunk size (0 = not a row-wise dataset)
+  int suggestedChunkRows { 0 };// suggested number of rows per chunk (0 = no suggestion)
+};
+
+// statistics of all files
+struct Summary {
+  double logicalCompressed { 0 }, storedCompressed { 0 };
+  double logicalUncompressed { 0 }, storedUncompressed { 0 };
+  vector<int> suggestedDefaultChunkSize;
+};
+
+size_t targetChunkBytes=64*1024;
+const size_t chunkCacheBytes=1024*1024; // default size of the HDF5 chunk cache per dataset
+bool summaryOnly=false;
+
+string size(double bytes) {
+  const char *unit[]={"B", "KiB", "MiB", "GiB", "TiB"};
+  int i=0;
+  for(; bytes>=1024 && i<4; ++i)
+    bytes/=1024;
+  ostringstream str;
+  str<<fixed<<setprecision(i==0?0:1)<<bytes<<" "<<unit[i];
+  return str.str();
+}
+
+string percent(double part, double total) {
+  ostringstream str;
+  str<<fixed<<setprecision(1)<<(total>0 ? 100*part/total : 0)<<"%";
+  return str.str();
+}
+
+// round v to two significant digits (clamped to the int range)
+int roundNice(double v) {
+  v=min(v, static_cast<double>(numeric_limits<int>::max()));
+  if(v<100)
+    return max(1, static_cast<int>(v));
+  double scale=pow(10, floor(log10(v))-1);
+  return static_cast<int>(floor(v/scale)*scale);
+}
+
+DatasetStat getDatasetStat(const string &path, hid_t dataset) {
+  DatasetStat stat;
+  stat.path=path;
+  stat.info=getDatasetInfo(dataset);
+  auto &info=stat.info;
+
+  stat.elements=1;
+  for(auto d : info.dims)
+    stat.elements*=d;
+  if(info.typeSize>0)
+    stat.logicalSize=static_cast<double>(stat.elements)*info.typeSize;
+  if(info.chunk.empty())
+    return stat;
+
+  stat.chunkElements=1;
+  for(auto c : info.chunk)
+    stat.chunkElements*=c;
+#if H5_VERSION_GE(1, 10, 5)
+  ScopedHID space(H5Dget_space(dataset), &H5Sclose);
+  H5Dget_num_chunks(dataset, space, &stat.chunks);
+#else
+  // estimate: all chunks covering the dataset are allocated
+  stat.chunks=1;
+  for(size_t i=0; i<info.dims.size(); ++i)
+    stat.chunks*=(info.dims[i]+info.chunk[i]-1)/info.chunk[i];
+#endif
+
+  // suggest a chunk size for row-wise appended datasets (VectorSerie: rank 2, 1D data: rank 1)
+  if(info.typeSize>0 && (info.dims.size()==1 || info.dims.size()==2)) {
+    size_t rowBytes=(info.dims.size()==2 ? info.chunk[1] : 1)*info.typeSize;
+    size_t chunkBytes=info.chunk[0]*rowBytes;
+    double rows=static_cast<double>(targetChunkBytes)/rowBytes;
+    if(info.maxDims[0]!=H5S_UNLIMITED)
+      rows=min(rows, static_cast<double>(max<hsize_t>(info.dims[0], 1)));
+    stat.idealChunkRows=roundNice(rows);
+    if((chunkBytes<targetChunkBytes/4 || chunkBytes>4*targetChunkBytes || chunkBytes>chunkCacheBytes) &&
+       static_cast<hsize_t>(stat.idealChunkRows)!=info.chunk[0])
+      stat.suggestedChunkRows=stat.idealChunkRows;
+  }
+  return stat;
+}
+
+herr_t getLinkNamesLCB(hid_t, const char *name, const H5L_info_t *, void *op_data) {
+  static_cast<vector<string>*>(op_data)->emplace_back(name);
+  return 0;
+}
+
+void walk(vector<DatasetStat> &stats, const string &path, GroupBase *obj) {
+  // all links, including the companion datasets which are not listed by getChildObjectNames
+  vector<string> names;
+  hsize_t idx=0;
+  H5Literate(obj->getID(), H5_INDEX_NAME, H5_ITER_NATIVE, &idx, &getLinkNamesLCB, &names);
+  // the companion datasets ".<name>.<kind>" are reported after the dataset <name> they belong to
+  map<string, vector<string>> companions;
+  for(const auto& name : names)
+    if(CompanionDataset::isCompanion(obj->getID(), name))
+      companions[name.substr(1, name.rfind('.')-1)].emplace_back(name);
+  for(const auto& name : names) {
+    if(CompanionDataset::isCompanion(obj->getID(), name))
+      continue;
+    if(obj->isExternalLink(name))
+      continue; // the linked file is reported separately if given
+    ScopedHID o(H5Oopen(obj->getID(), name.c_str(), H5P_DEFAULT), &H5Oclose);
+    H5I_type_t type=H5Iget_type(o);
+    if(type==H5I_GROUP)
+      walk(stats, path+"/"+name, obj->openChildObject<Group>(name));
+    else if(type==H5I_DATASET) {
+      stats.emplace_back(getDatasetStat(path+"/"+name, o));
+      for(const auto& c : companions[name]) {
+        ScopedHID co(H5Dopen2(obj->getID(), c.c_str(), H5P_DEFAULT), &H5Dclose);
+        stats.emplace_back(getDatasetStat(path+"/"+c, co));
+        stats.back().companion=true;
+      }
+    }
+  }
+}
+
+void printFileStat(const string &filename, Summary &summary) {
+  File file(filename, File::read);
+  vector<DatasetStat> stats;
+  walk(stats, "", &file);
+
+  hsize_t fileSize;
+  H5Fget_filesize(file.getID(), &fileSize);
+  hssize_t freeSpace=max<hssize_t>(0, H5Fget_freespace(file.getID()));
+  double stored=0;
+  size_t companions=0;
+  for(auto &s : stats) {
+    stored+=s.info.storageSize;
+    companions+=s.companion;
+  }
+  double overhead=max(0.0, fileSize-stored-freeSpace);
+  cout<<filename<<": "<<size(fileSize)<<", "<<stats.size()-companions<<" datasets (and "<<companions<<" companion datasets), raw data "<<size(stored)<<" ("<<percent(stored, fileSize)<<"), "
+      <<"free space "<<size(freeSpace)<<" ("<<percent(freeSpace, fileSize)<<"), "
+      <<"other overhead "<<size(overhead)<<" ("<<percent(overhead, fileSize)<<")"<<endl;
+
+  for(auto &s : stats) {
+    auto &info=s.info;
+    if(s.logicalSize>=0) {
+      if(info.filters.empty()) {
+        summary.logicalUncompressed+=s.logicalSize;
+        summary.storedUncompressed+=info.storageSize;
+      }
+      else {
+        summary.logicalCompressed+=s.logicalSize;
+        summary.storedCompressed+=info.storageSize;
+      }
+    }
+    // all unlimited 2D datasets (not only the ones with a suggestion) contribute to the default chunk size
+    // (companion datasets are chunked by the dataset they belong to)
+    if(!s.companion && s.idealChunkRows>0 && info.dims.size()==2 && info.maxDims[0]==H5S_UNLIMITED)
+      summary.suggestedDefaultChunkSize.push_back(s.idealChunkRows);
+    if(summaryOnly)
+      continue;
+
+    // companion datasets are indented below the dataset they belong to
+    string indent=s.companion ? "  " : "";
+    cout<<indent<<"  "<<(s.companion ? "companion " : "")<<s.path<<": "<<info.datatype<<", "<<dimString(info.dims)<<" (max "<<dimString(info.maxDims)<<"), filters: ";
+    if(info.filters.empty())
+      cout<<"none";
+    for(size_t i=0; i<info.filters.size(); ++i)
+      cout<<(i==0?"":", ")<<info.filters[i].name
+          <<(info.filters[i].name=="deflate" && !info.filters[i].param.empty() ? "("+to_string(info.filters[i].param[0])+")" : "");
+    cout<<endl;
+
+    cout<<indent<<"    logical "<<(s.logicalSize>=0 ? size(s.logicalSize) : "unknown (variable length)")<<", stored "<<size(info.storageSize);
+    if(s.logicalSize>=0 && info.storageSize>0) {
+      ostringstream ratio;
+      ratio<<fixed<<setprecision(2)<<s.logicalSize/info.storageSize;
+      cout<<", compression ratio "<<ratio.str();
+    }
+    cout<<endl;
+
+    if(!info.chunk.empty()) {
+      cout<<indent<<"    chunk "<<dimString(info.chunk);
+      if(info.typeSize>0)
+        cout<<" ("<<size(static_cast<double>(s.chunkElements)*info.typeSize)<<")";
+      cout<<", "<<s.chunks<<" chunks";
+      if(s.chunks>0)
+        cout<<", average fill "<<percent(s.elements, static_cast<double>(s.chunks)*s.chunkElements)
+            <<", average stored chunk "<<size(static_cast<double>(info.storageSize)/s.chunks);
+      cout<<endl;
+    }
+    else
+      cout<<indent<<"    not chunked"<<endl;
+
+    string hint;
+    if(s.suggestedChunkRows>0 && !s.companion) {
+      vector<hsize_t> chunk(info.chunk);
+      chunk[0]=s.suggestedChunkRows;
+      hint="use chunk "+dimString(chunk)+" ("+size(static_cast<double>(s.suggestedChunkRows)*s.chunkElements/info.chunk[0]*info.typeSize)+")";
+    }
+    if(!info.filters.empty() && s.logicalSize>0 && info.storageSize>0 && s.logicalSize/info.storageSize<1.1)
+      hint+=(hint.empty()?"":"; ")+string("compression is ineffective");
+    if(!hint.empty())
+      cout<<indent<<"    suggestion: "<<hint<<endl;
+  }
+}
+
+void printhelp() {
+cout<<
+"h5statserie"<<endl<<
+""<<endl<<
+"Reports storage and compression statistics of the datasets in hdf5 files and"<<endl<<
+"suggests better chunk sizes."<<endl<<
+""<<endl<<
+"Copyright (C) 2026 Markus Friedrich <friedrich.at.gc@googlemail.com>"<<endl<<
+"This is free software; see the source for copying conditions. There is NO"<<endl<<
+"warranty; not even for MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE."<<endl<<
+""<<endl<<
+"Licensed under the GNU Lesser General Public License (LGPL)"<<endl<<
+""<<endl<<
+"Usage:"<<endl<<
+"  h5statserie [-s] [-c <bytes>] [-h|--help] <file.h5> ..."<<endl<<
+"    -h, --help:  Show this help"<<endl<<
+"    -s:          Print only the file and overall summary, no dataset details"<<endl<<
+"    -c <bytes>:  Target size of a chunk for the suggestions (default 65536)"<<endl<<
+""<<endl<<
+"For each file the file size, the size of the raw data of all datasets, the"<<endl<<
+"free space and the other overhead (object headers, chunk indices,"<<endl<<
+"attributes, unused space not tracked as free space) is printed. For each"<<endl<<
+"dataset the logical (uncompressed) size, the stored size, the compression"<<endl<<
+"ratio, the filter pipeline, the number of allocated chunks and the average"<<endl<<
+"fill of these chunks is printed. The hidden companion datasets of a dataset"<<endl<<
+"(pyramid, time index, zone map) are reported below this dataset."<<endl<<
+"A chunk size is suggested if the current chunk is much smaller or larger"<<endl<<
+"than the target size or does not fit into the HDF5 chunk cache (1 MiB)."<<endl<<
+"The overall summary suggests a value for File::setDefaultChunkSize (rows"<<endl<<
+"per chunk for the target size, median over all unlimited 2D datasets) and"<<endl<<
+"compares the compression ratio of compressed and uncompressed datasets."<<endl;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+#ifndef _WIN32
+  assert(feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW)!=-1);
+#endif
+
+  vector<string> files;
+  for(int i=1; i<argc; i++) {
+    if(strcmp(argv[i], "-h")==0 || strcmp(argv[i], "--help")==0) {
+      printhelp();
+      return 0;
+    }
+    else if(strcmp(argv[i], "-s")==0) summaryOnly=true;
+    else if(strcmp(argv[i], "-c")==0 && i+1<argc) targetChunkBytes=max(1L, atol(argv[++i]));
+    else files.emplace_back(argv[i]);
+  }
+  if(files.empty()) {
+    printhelp();
+    return 0;
+  }
+
+  int ret=0;
+  Summary summary;
+  for(auto &filename : files) {
+    try {
+      printFileStat(filename, summary);
+    }
+    catch(const exception &ex) {
+      cerr<<ex.what()<<endl;
+      ret=1;
+    }
+  }
+
+  cout<<"Summary:"<<endl;
+  auto ratio=[](double logical, double stored) {
+    ostringstream str;
+    str<<fixed<<setprecision(2)<<(stored>0 ? logical/stored : 0);
+    return str.str();
+  };
+  cout<<"  compressed datasets: logical "<<size(summary.logicalCompressed)<<", stored "<<size(summary.storedCompressed)
+      <<", compression ratio "<<ratio(summary.logicalCompressed, summary.storedCompressed)<<endl;
+  cout<<"  uncompressed datasets: logical "<<size(summary.logicalUncompressed)<<", stored "<<size(summary.storedUncompressed)<<endl;
+  auto &s=summary.suggestedDefaultChunkSize;
+  if(!s.empty()) {
+    nth_element(s.begin(), s.begin()+s.size()/2, s.end());
+    cout<<"  suggested File::setDefaultChunkSize: "<<s[s.size()/2]<<" (currently "<<File::getDefaultChunkSize()<<")"<<endl;
+  }
+  return ret;
+}
@@ -31,6 +31,8 @@
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
 #include <boost/interprocess/sync/interprocess_condition.hpp>
 #include <boost/lexical_cast.hpp>
+#include <thread>
+#include "predictfilter.h"
 
 using namespace std;
 using namespace boost::interprocess;
@@ -41,6 +43,8 @@ namespace {
   void requestWriterFlush(H5::File::IPC &ipc, H5::File *me);
   void openIPC(H5::File::IPC &ipc, const boost::filesystem::path &filename);
   bool waitForWriterFlush(H5::File::IPC &ipc, H5::File *me);
+  void setMetadataCacheSize(hid_t faid, size_t size);
+  void setMetadataCacheImage(hid_t faid);
 
   class RunAtExit {
     public:
@@ -51,22 +55,54 @@ namespace {
       set<string> ipcRemove;
   };
   RunAtExit runatexit;
+
+  // The layout of the shared memory of a IPC: flushVar, mutex, cond. The mutex and the condition must be aligned,
+  // else waiting on the condition never blocks nor times out.
+  constexpr size_t alignUp(size_t offset, size_t align) { return (offset+align-1)/align*align; }
+  constexpr size_t ipcMutexOffset=alignUp(sizeof(bool), alignof(interprocess_mutex));
+  constexpr size_t ipcCondOffset=alignUp(ipcMutexOffset+sizeof(interprocess_mutex), alignof(interprocess_condition));
+  constexpr size_t ipcSize=ipcCondOffset+sizeof(interprocess_condition);
+
+  // The name of the interprocess elements of the file \p filename (a absolute path).
+  // The name includes the version of the shared memory layout: writers and readers using a different layout
+  // (e.g. of a older hdf5serie version using unaligned elements) do not see the elements of each other
+  // instead of misinterpreting the shared memory.
+  string ipcName(const string &filename) {
+    return "hdf5serie_ipc2_"+to_string(hash<string>()(filename));
+  }
 }
 
 namespace H5 {
 
 int File::defaultCompression=1;
 int File::defaultChunkSize=100;
+int File::numberOfWorkerThreads=max(1u, thread::hardware_concurrency());
 
 set<File*> File::writerFiles;
 set<File*> File::readerFiles;
 
-File::File(const path &filename, FileAccess type_) : GroupBase(nullptr, filename.string()), type(type_), isSWMR(false) {
+File::Options File::Options::appendHeavyTimeSeries() {
+  Options opt;
+  opt.pagedAggregation=true;
+  opt.pageSize=64*1024;
+  opt.pageBufferSize=16*opt.pageSize;
+  opt.metaBlockSize=opt.pageSize;
+  opt.smallDataBlockSize=opt.pageSize;
+  return opt;
+}
+
+File::File(const path &filename, FileAccess type_) : File(filename, type_, Options()) {
+}
+
+File::File(const path &filename, FileAccess type_, const Options &options_) : GroupBase(nullptr, filename.string()),
+  type(type_), options(options_), isSWMR(false) {
+  if(type==read && options.inMemory)
+    throw Exception(getPath(), "In-memory files are only supported for writing");
   file=this;
   open();
 
-  interprocessName=canonical(filename).string();
-  interprocessName="hdf5serie_"+to_string(hash<string>()(interprocessName));
+  // a in-memory file without backing store does not exist on disk
+  interprocessName=ipcName((exists(filename) ? canonical(filename) : absolute(filename)).string());
 
   if(type==write) {
     writerFiles.insert(this);
@@ -77,16 +113,16 @@ File::File(const path &filename, FileAccess type_) : GroupBase(nullptr, filename
     // create interprocess elements
     ipc.filename=filename;
 #ifdef _WIN32
-    ipc.shm=std::make_shared<windows_shared_memory>(create_only, interprocessName.c_str(), read_write, sizeof(bool)+sizeof(interprocess_mutex)+sizeof(interprocess_condition));
+    ipc.shm=std::make_shared<windows_shared_memory>(create_only, interprocessName.c_str(), read_write, ipcSize);
 #else
     ipc.shm=std::make_shared<shared_memory_object>(create_only, interprocessName.c_str(), read_write);
-    ipc.shm->truncate(sizeof(bool)+sizeof(interprocess_mutex)+sizeof(interprocess_condition));
+    ipc.shm->truncate(ipcSize);
 #endif
     ipc.shmmap=std::make_shared<mapped_region>(*ipc.shm, read_write);
     auto *ptr=static_cast<char*>(ipc.shmmap->get_address());
-    ipc.flushVar=new(ptr) bool(false);               ptr+=sizeof(bool);
-    ipc.mutex   =new(ptr) interprocess_mutex();      ptr+=sizeof(interprocess_mutex);
-    ipc.cond    =new(ptr) interprocess_condition();//ptr+=sizeof(interprocess_condition);
+    ipc.flushVar=new(ptr) bool(false);
+    ipc.mutex   =new(ptr+ipcMutexOffset) interprocess_mutex();
+    ipc.cond    =new(ptr+ipcCondOffset) interprocess_condition();
 
     runatexit.addIPCRemove(interprocessName);
   }
@@ -122,6 +158,15 @@ File::~File() {
   }
 
   close();
+
+  if(type==write && isSWMR && options.metadataCacheImage) {
+    try {
+      writeMetadataCacheImage();
+    }
+    catch(const std::exception &ex) {
+      msg(Warn)<<"Writing the metadata cache image of file "<<name<<" failed: "<<ex.what()<<endl;
+    }
+  }
 }
 
 void File::reopenAsSWMR() {
@@ -131,6 +176,12 @@ void File::reopenAsSWMR() {
     msg(Warn)<<"reopenAsSWMR called more than once for file "<<name<<". Skipping this call (must be reworked after the HDF5 1.10 release)"<<endl;
     return;
   }
+  if(options.inMemory) {
+    // the core driver does not support SWMR: just write the current state to disk
+    msg(Debug)<<"The in-memory file "<<name<<" cannot be reopened in SWMR mode. Flushing it instead."<<endl;
+    flush();
+    return;
+  }
 
   isSWMR=true;
 
@@ -162,6 +213,9 @@ void File::flush() {
 
 #if H5_VERSION_GE(1, 10, 0)
   GroupBase::flush();
+  // a dataset flush does not write the in-memory image to the backing store
+  if(options.inMemory)
+    H5Fflush(id, H5F_SCOPE_GLOBAL);
 #else
   H5Fflush(id, H5F_SCOPE_GLOBAL);
 #endif
@@ -197,18 +251,41 @@ void File::close() {
 }
 
 void File::open() {
+  // the filters of this library must be known by HDF5 before any dataset is created or read
+  registerPredictFilter();
+  ScopedHID faid(H5Pcreate(H5P_FILE_ACCESS), &H5Pclose);
+  if(options.inMemory)
+    H5Pset_fapl_core(faid, options.inMemoryIncrement, options.backingStore);
+  if(options.metadataCacheSize>0)
+    setMetadataCacheSize(faid, options.metadataCacheSize);
+#if H5_VERSION_GE(1, 10, 1)
+  if(type==write && !isSWMR && options.metadataCacheImage)
+    setMetadataCacheImage(faid);
+  if(options.pageBufferSize>0)
+    H5Pset_page_buffer_size(faid, options.pageBufferSize, 0, 0);
+#endif
+  if(options.metaBlockSize>0)
+    H5Pset_meta_block_size(faid, options.metaBlockSize);
+  if(options.smallDataBlockSize>0)
+    H5Pset_small_data_block_size(faid, options.smallDataBlockSize);
   if(type==write) {
     if(!isSWMR) {
-      ScopedHID faid(H5Pcreate(H5P_FILE_ACCESS), &H5Pclose);
       H5Pset_libver_bounds(faid, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
-      id.reset(H5Fcreate(name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, faid), &H5Fclose);
+      ScopedHID fcid(H5Pcreate(H5P_FILE_CREATE), &H5Pclose);
+#if H5_VERSION_GE(1, 10, 1)
+      if(options.pagedAggregation) {
+        H5Pset_file_space_strategy(fcid, H5F_FSPACE_STRATEGY_PAGE, false, 1);
+        H5Pset_file_space_page_size(fcid, options.pageSize);
+      }
+#endif
+      id.reset(H5Fcreate(name.c_str(), H5F_ACC_TRUNC, fcid, faid), &H5Fclose);
     }
     else {
       unsigned int flag=H5F_ACC_RDWR;
 #if H5_VERSION_GE(1, 10, 0)
       flag|=H5F_ACC_SWMR_WRITE;
 #endif
-      id.reset(H5Fopen(name.c_str(), flag, H5P_DEFAULT), &H5Fclose);
+      id.reset(H5Fopen(name.c_str(), flag, faid), &H5Fclose);
     }
   }
   else {
@@ -216,11 +293,26 @@ void File::open() {
 #if H5_VERSION_GE(1, 10, 0)
     flag|=H5F_ACC_SWMR_READ;
 #endif
-    id.reset(H5Fopen(name.c_str(), flag, H5P_DEFAULT), &H5Fclose);
+    id.reset(H5Fopen(name.c_str(), flag, faid), &H5Fclose);
   }
   GroupBase::open();
 }
 
+void File::writeMetadataCacheImage() {
+#if H5_VERSION_GE(1, 10, 1)
+  // reopen the file without SWMR (cache images are not supported in SWMR mode), load the object headers of all objects
+  // into the metadata cache and close it again, which writes the metadata cache image
+  ScopedHID faid(H5Pcreate(H5P_FILE_ACCESS), &H5Pclose);
+  if(options.metadataCacheSize>0)
+    setMetadataCacheSize(faid, options.metadataCacheSize);
+  setMetadataCacheImage(faid);
+  ScopedHID fid(H5Fopen(name.c_str(), H5F_ACC_RDWR, faid), &H5Fclose);
+  H5Ovisit(fid, H5_INDEX_NAME, H5_ITER_NATIVE, [](hid_t, const char *, const H5O_info_t *, void *) -> herr_t {
+    return 0;
+  }, nullptr);
+#endif
+}
+
 
 
 void File::flushIfRequested() {
@@ -301,6 +393,45 @@ void File::addFileToNotifyOnRefresh(const boost::filesystem::path &filename) {
   ipcAdd.push_back(ipc);
 }
 
+WriterFlushClient::WriterFlushClient(const path &filename_) : filename(filename_) {
+}
+
+bool WriterFlushClient::requestFlush() {
+  if(!ipc.shm) {
+    // (re)attach the interprocess elements of the writer
+    if(!exists(filename))
+      return false;
+    openIPC(ipc, filename);
+    if(!ipc.shm)
+      return false;
+  }
+  {
+    boost::interprocess::scoped_lock<interprocess_mutex> lock(*ipc.mutex);
+    *ipc.flushVar=true;
+  }
+  ipc.flushRequestTime=microsec_clock::universal_time();
+  return true;
+}
+
+long WriterFlushClient::waitForFlush(int msec) {
+  if(!ipc.shm)
+    return -1;
+  bool flushed=true;
+  {
+    boost::interprocess::scoped_lock<interprocess_mutex> lock(*ipc.mutex);
+    while(*ipc.flushVar && flushed)
+      flushed=ipc.cond->timed_wait(lock, ipc.flushRequestTime+milliseconds(msec));
+    flushed=!*ipc.flushVar;
+  }
+  if(!flushed) {
+    // the writer may not exist anymore or was restarted (with new interprocess elements): attach again on next request
+    ipc.shmmap.reset();
+    ipc.shm.reset();
+    return -1;
+  }
+  return (microsec_clock::universal_time()-ipc.flushRequestTime).total_microseconds();
+}
+
 }
 
 namespace {
@@ -332,7 +463,7 @@ bool waitForWriterFlush(H5::File::IPC &ipc, H5::File *me) {
   {
     boost::interprocess::scoped_lock<interprocess_mutex> lock(*ipc.mutex);
     if(*ipc.flushVar) {
-      flushReady=ipc.cond->timed_wait(lock, ipc.flushRequestTime+milliseconds(msec));//MFMF not working; never timeout out
+      flushReady=ipc.cond->timed_wait(lock, ipc.flushRequestTime+milliseconds(msec));
     }
   }
   // print message
@@ -349,8 +480,7 @@ bool waitForWriterFlush(H5::File::IPC &ipc, H5::File *me) {
 }
 
 void openIPC(H5::File::IPC &ipc, const path &filename) {
-  string interprocessName=canonical(filename).string();
-  interprocessName="hdf5serie_"+to_string(hash<string>()(interprocessName));
+  string interprocessName=ipcName(canonical(filename).string());
   try {
     ipc.filename=filename;
     ipc.interprocessName=interprocessName;
@@ -360,10 +490,16 @@ void openIPC(H5::File::IPC &ipc, const path &filename) {
     ipc.shm=std::make_shared<shared_memory_object>(open_only, interprocessName.c_str(), read_write);
 #endif
     ipc.shmmap=std::make_shared<mapped_region>(*ipc.shm, read_write);
+    if(ipc.shmmap->get_size()<ipcSize) {
+      // not created by a writer with the same layout: handle like no writer exists
+      ipc.shm.reset();
+      ipc.shmmap.reset();
+      return;
+    }
     auto *ptr=static_cast<char*>(ipc.shmmap->get_address());
-    ipc.flushVar=reinterpret_cast<bool*>                  (ptr);  ptr+=sizeof(bool);
-    ipc.mutex   =reinterpret_cast<interprocess_mutex*>    (ptr);  ptr+=sizeof(interprocess_mutex);
-    ipc.cond    =reinterpret_cast<interprocess_condition*>(ptr);//ptr+=sizeof(interprocess_condition);
+    ipc.flushVar=reinterpret_cast<bool*>                  (ptr);
+    ipc.mutex   =reinterpret_cast<interprocess_mutex*>    (ptr+ipcMutexOffset);
+    ipc.cond    =reinterpret_cast<interprocess_condition*>(ptr+ipcCondOffset);
   }
   catch(const interprocess_exception &ex) {
     ipc.shm.reset();
@@ -371,6 +507,28 @@ void openIPC(H5::File::IPC &ipc, const path &filename) {
   }
 }
 
+void setMetadataCacheSize(hid_t faid, size_t size) {
+  H5AC_cache_config_t config;
+  config.version=H5AC__CURR_CACHE_CONFIG_VERSION;
+  H5Pget_mdc_config(faid, &config);
+  config.set_initial_size=true;
+  config.initial_size=size;
+  config.min_size=size;
+  config.max_size=max(config.max_size, size);
+  H5Pset_mdc_config(faid, &config);
+}
+
+void setMetadataCacheImage(hid_t faid) {
+#if H5_VERSION_GE(1, 10, 1)
+  H5AC_cache_image_config_t config;
+  config.version=H5AC__CURR_CACHE_IMAGE_CONFIG_VERSION;
+  config.generate_image=true;
+  config.save_resize_status=false;
+  config.entry_ageout=H5AC__CACHE_IMAGE__ENTRY_AGEOUT__NONE;
+  H5Pset_mdc_image_config(faid, &config);
+#endif
+}
+
 RunAtExit::~RunAtExit() {
 #ifndef _WIN32
   for(const auto & it : ipcRemove)
@@ -51,14 +51,55 @@ namespace H5 {
         read,
         write
       };
+      //! Tuning options of the HDF5 file. Only used when the file is opened (passed to the constructor).
+      struct Options {
+        //! Use the HDF5 core driver: the whole file is hold in memory and written to disk on close() and on flush().
+        //! This avoids many small file system operations, e.g. for short simulations writing many small files.
+        //! The core driver does not support SWMR: reopenAsSWMR() just flushes the file in this case.
+        //! Only supported for files opened for writing.
+        bool inMemory { false };
+        //! If false, a in-memory file is never written to disk (only useful for testing).
+        bool backingStore { true };
+        //! The memory increment (in bytes) used when a in-memory file grows.
+        size_t inMemoryIncrement { 1024*1024 };
+        //! Use paged aggregation (H5F_FSPACE_STRATEGY_PAGE): metadata and small raw data are aggregated in pages
+        //! of pageSize bytes. Only used when the file is created; the strategy is stored in the file.
+        bool pagedAggregation { false };
+        //! The file space page size (in bytes) used if pagedAggregation is true.
+        hsize_t pageSize { 4096 };
+        //! The size of the page buffer (in bytes, a multiple of the page size of the file). 0 = no page buffer.
+        //! Can only be used for files created with pagedAggregation (also for readers).
+        size_t pageBufferSize { 0 };
+        //! The minimal size (in bytes) of metadata block allocations. 0 = HDF5 default.
+        hsize_t metaBlockSize { 0 };
+        //! The minimal size (in bytes) of small raw data block allocations. 0 = HDF5 default.
+        hsize_t smallDataBlockSize { 0 };
+
+        //! The size (in bytes) of the metadata cache. The cache is not shrunk below this size. 0 = HDF5 default.
+        size_t metadataCacheSize { 0 };
+        //! Write a metadata cache image when the file is closed: readers load the cached metadata in one read on open.
+        //! HDF5 does not support cache images in SWMR mode: for files reopened as SWMR the image is written by
+        //! reopening the file without SWMR, visiting all objects and closing it again in the destructor.
+        bool metadataCacheImage { false };
+
+        //! Presets for files with many time series which are appended row by row:
+        //! large pages, a page buffer and large aggregation blocks, to avoid many small scattered writes.
+        static Options appendHeavyTimeSeries();
+      };
       File(const boost::filesystem::path &filename, FileAccess type_);
+      File(const boost::filesystem::path &filename, FileAccess type_, const Options &options_);
       ~File() override;
       void reopenAsSWMR();
       static void reopenAllFilesAsSWMR();
+      FileAccess getType() const { return type; }
       static int getDefaultCompression() { return defaultCompression; }
       static void setDefaultCompression(int comp) { defaultCompression=comp; }
       static int getDefaultChunkSize() { return defaultChunkSize; }
       static void setDefaultChunkSize(int chunk) { defaultChunkSize=chunk; }
+      //! The number of worker threads used by this library, e.g. to compress chunks (default: number of cores).
+      static int getNumberOfWorkerThreads() { return numberOfWorkerThreads; }
+      //! Set the number of worker threads; values < 1 are handled as 1 (tasks like the direct chunk write need a worker).
+      static void setNumberOfWorkerThreads(int n) { numberOfWorkerThreads=n<1 ? 1 : n; }
       void refresh() override;
       void flush() override;
 
@@ -89,11 +130,14 @@ namespace H5 {
       };
     protected:
       FileAccess type;
+      Options options;
       bool isSWMR;
       void close() override;
       void open() override;
+      void writeMetadataCacheImage();
       static int defaultCompression;
       static int defaultChunkSize;
+      static int numberOfWorkerThreads;
 
       static std::set<File*> writerFiles;
       static std::set<File*> readerFiles;
@@ -102,6 +146,30 @@ namespace H5 {
       void addFileToNotifyOnRefresh(const boost::filesystem::path &filename);
       std::vector<IPC> ipcAdd;
   };
+
+  /** \brief Requests flushes of the writer process of a file without opening the file
+   *
+   * Only the interprocess elements (shared memory) created by the writer process are attached; the HDF5 file itself is
+   * not opened. A flush request hence costs no HDF5 call at all, e.g. for long running processes requesting flushes of
+   * many files periodically (see h5flushserie -d).
+   * If no writer process exists, or the writer did not flush in time (e.g. because it was restarted), the interprocess
+   * elements are attached again on the next request.
+   */
+  class WriterFlushClient {
+    public:
+      WriterFlushClient(const boost::filesystem::path &filename_);
+
+      //! Request a flush from the writer process. Returns false if no writer process exists.
+      bool requestFlush();
+
+      //! Wait at most \a msec milliseconds until the writer has flushed the file after the last requestFlush().
+      //! Returns the time from the request until the flush in microseconds or -1 if the file was not flushed.
+      long waitForFlush(int msec);
+
+    private:
+      boost::filesystem::path filename;
+      File::IPC ipc;
+  };
 }
 
 #endif
@@ -24,6 +24,7 @@
 #include <hdf5serie/simpledataset.h>
 #include <hdf5serie/vectorserie.h>
 #include <hdf5serie/toh5type.h>
+#include "companiondataset.h"
 #include <vector>
 #include <optional>
 
@@ -31,10 +32,12 @@ using namespace std;
 using namespace boost::filesystem;
 
 namespace {
-  herr_t getChildNamesLCB(hid_t, const char *name, const H5L_info_t *, void *op_data) {
+  herr_t getChildNamesLCB(hid_t group, const char *name, const H5L_info_t *, void *op_data) {
     pair<std::optional<exception>, set<string>> &ret=*static_cast<pair<std::optional<exception>, set<string>>*>(op_data);
     try {
-      ret.second.insert(name);
+      // companion datasets are not part of the object tree
+      if(!H5::CompanionDataset::isCompanion(group, name))
+        ret.second.insert(name);
     }
     catch(exception &ex) {
       ret.first=ex;
@@ -0,0 +1,122 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include <hdf5serie/mappedvectorserie.h>
+#include <hdf5serie/toh5type.h>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+using namespace std;
+using namespace boost::interprocess;
+
+namespace H5 {
+
+  template<class T>
+  MappedVectorSerie<T>::MappedVectorSerie(VectorSerie<T> *vs_) : vs(vs_) {
+    refresh();
+  }
+
+  template<class T>
+  MappedVectorSerie<T>::~MappedVectorSerie() = default;
+
+  template<class T>
+  void MappedVectorSerie<T>::refresh() {
+#if H5_VERSION_GE(1, 10, 5)
+    region.reset();
+    fileMapping.reset();
+    chunkAddr.clear();
+
+    hid_t id=vs->getID();
+    // check the dataset
+    ScopedHID cpl(H5Dget_create_plist(id), &H5Pclose);
+    if(H5Pget_layout(cpl)!=H5D_CHUNKED)
+      throw Exception(vs->getPath(), "Only chunked datasets can be memory mapped.");
+    if(H5Pget_nfilters(cpl)!=0)
+      throw Exception(vs->getPath(), "Only datasets without filters (compression) can be memory mapped.");
+    hsize_t chunkDims[2];
+    H5Pget_chunk(cpl, 2, chunkDims);
+    cols=vs->getColumns();
+    if(chunkDims[1]!=cols)
+      throw Exception(vs->getPath(), "Only datasets with chunks covering all columns can be memory mapped.");
+    chunkSize=chunkDims[0];
+    ScopedHID ftype(H5Dget_type(id), &H5Tclose);
+    T dummy;
+    if(H5Tequal(ftype, toH5Type(dummy))<=0)
+      throw Exception(vs->getPath(), "Only datasets with a file datatype equal to the native datatype can be memory mapped.");
+
+    // resolve the chunk addresses
+    rows=vs->getRows();
+    size_t nChunks=(rows+chunkSize-1)/chunkSize;
+    chunkAddr.resize(nChunks);
+    ScopedHID fileSpace(H5Dget_space(id), &H5Sclose);
+    for(size_t c=0; c<nChunks; ++c) {
+      hsize_t offset[]={c*chunkSize, 0};
+      unsigned filterMask;
+      hsize_t size;
+      H5Dget_chunk_info_by_coord(id, offset, &filterMask, &chunkAddr[c], &size);
+      if(chunkAddr[c]!=HADDR_UNDEF && size!=chunkSize*cols*sizeof(T))
+        throw Exception(vs->getPath(), "Internal error: unexpected chunk size.");
+    }
+
+    // map the file
+    if(nChunks>0) {
+      fileMapping=make_shared<file_mapping>(vs->getFile()->getName().c_str(), read_only);
+      region=make_shared<mapped_region>(*fileMapping, read_only);
+      for(auto &addr : chunkAddr)
+        if(addr!=HADDR_UNDEF && addr+chunkSize*cols*sizeof(T)>region->get_size())
+          throw Exception(vs->getPath(), "A chunk lies outside of the mapped file.");
+    }
+#else
+    throw Exception(vs->getPath(), "Memory mapping a dataset requires HDF5 >= 1.10.5.");
+#endif
+  }
+
+  template<class T>
+  const T* MappedVectorSerie<T>::chunkData(size_t chunk) {
+    if(chunk>=chunkAddr.size())
+      throw Exception(vs->getPath(), "Requested chunk "+to_string(chunk)+" is out of range.");
+    if(chunkAddr[chunk]==HADDR_UNDEF)
+      throw Exception(vs->getPath(), "Requested chunk "+to_string(chunk)+" is not allocated in the file.");
+    return reinterpret_cast<const T*>(static_cast<const char*>(region->get_address())+chunkAddr[chunk]);
+  }
+
+  template<class T>
+  Span<const T> MappedVectorSerie<T>::getRow(size_t row) {
+    if(row>=rows)
+      throw Exception(vs->getPath(), "Requested row "+to_string(row)+" is out of range [0.."+to_string(rows)+"[.");
+    return Span<const T>(chunkData(row/chunkSize)+(row%chunkSize)*cols, cols);
+  }
+
+  template<class T>
+  Span<const T> MappedVectorSerie<T>::getChunk(size_t chunk) {
+    const T *data=chunkData(chunk);
+    return Span<const T>(data, min(chunkSize, rows-chunk*chunkSize)*cols);
+  }
+
+  // explizit template instantations
+
+# define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
+  template class MappedVectorSerie<CTYPE>;
+# include "hdf5serie/knownpodtypes.def"
+# undef FOREACHKNOWNTYPE
+
+}
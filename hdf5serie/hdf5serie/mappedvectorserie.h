@@ -0,0 +1,92 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#ifndef _HDF5SERIE_MAPPEDVECTORSERIE_H_
+#define _HDF5SERIE_MAPPEDVECTORSERIE_H_
+
+#include <hdf5serie/vectorserie.h>
+#include <hdf5serie/span.h>
+#include <memory>
+#include <vector>
+
+namespace boost {
+  namespace interprocess {
+    class file_mapping;
+    class mapped_region;
+  }
+}
+
+namespace H5 {
+
+  /** \brief Zero-copy read access to a uncompressed VectorSerie.
+   *
+   * The addresses of all chunks of the dataset are resolved once and the file is memory mapped.
+   * Rows and chunks are then returned as views into the mapped file without any HDF5 read call or copy.
+   *
+   * Only datasets without any filter (compression 0), with chunks covering all columns and with a file datatype
+   * equal to the native datatype of T are supported. Requires HDF5 >= 1.10.5.
+   *
+   * Rows appended to the dataset after the construction or the last call of refresh() are not visible.
+   * The returned views are valid until refresh() is called or this object is destructed.
+   */
+  template<class T>
+  class MappedVectorSerie {
+    public:
+      //! Map the dataset vs (which must be a dataset of a file opened for reading).
+      MappedVectorSerie(VectorSerie<T> *vs_);
+      ~MappedVectorSerie();
+
+      //! Resolve the chunk addresses and map the file again, to make newly appended rows visible.
+      void refresh();
+
+      //! Returns the number of rows visible by this object.
+      size_t getRows() { return rows; }
+
+      //! Returns the number of columns.
+      size_t getColumns() { return cols; }
+
+      //! Returns the number of rows per chunk.
+      size_t getChunkSize() { return chunkSize; }
+
+      //! Returns the number of chunks (the last one may be only partially filled).
+      size_t getNumberOfChunks() { return chunkAddr.size(); }
+
+      //! Returns a view of the row \a row (of size getColumns()).
+      Span<const T> getRow(size_t row);
+
+      //! Returns a view of all rows of chunk \a chunk (row-major, of size getColumns() times the number of rows
+      //! of this chunk, which is getChunkSize() except for the last chunk).
+      Span<const T> getChunk(size_t chunk);
+
+    private:
+      VectorSerie<T> *vs;
+      size_t rows { 0 };
+      size_t cols { 0 };
+      size_t chunkSize { 0 };
+      std::vector<haddr_t> chunkAddr;
+      std::shared_ptr<boost::interprocess::file_mapping> fileMapping;
+      std::shared_ptr<boost::interprocess::mapped_region> region;
+      const T* chunkData(size_t chunk);
+  };
+
+}
+
+#endif
@@ -0,0 +1,177 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include "predictfilter.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+  struct Layout {
+    vector<int> mode; // the mode of each column
+    size_t elemSize, cols, rows;
+  };
+
+  Layout getLayout(size_t size, const vector<unsigned int> &cdValues) {
+    if(cdValues.size()<4 || cdValues[2]==0 || cdValues[2]>8 || cdValues[3]==0 ||
+       (cdValues.size()>4 && cdValues.size()!=4+cdValues[3]))
+      throw runtime_error("Invalid parameters of the predictive filter.");
+    Layout l { {}, cdValues[2], cdValues[3], 0 };
+    if(cdValues.size()>4)
+      l.mode.assign(cdValues.begin()+4, cdValues.end());
+    else {
+      l.mode.resize(l.cols, static_cast<int>(cdValues[1]));
+      l.mode[0]=static_cast<int>(cdValues[0]);
+    }
+    l.rows=size/(l.elemSize*l.cols);
+    return l;
+  }
+
+  inline uint64_t load(const char *p, size_t n) {
+    uint64_t v=0;
+    for(size_t b=0; b<n; ++b)
+      v|=static_cast<uint64_t>(static_cast<unsigned char>(p[b]))<<(8*b);
+    return v;
+  }
+
+  inline void store(char *p, size_t n, uint64_t v) {
+    for(size_t b=0; b<n; ++b)
+      p[b]=static_cast<char>(v>>(8*b));
+  }
+
+  size_t filter(unsigned int flags, size_t cdNElmts, const unsigned int cdValues[], size_t nbytes, size_t *bufSize, void **buf) {
+    try {
+      vector<unsigned int> cd(cdValues, cdValues+cdNElmts);
+      vector<char> out=(flags & H5Z_FLAG_REVERSE) ?
+        H5::predictDecode(static_cast<char*>(*buf), nbytes, cd) :
+        H5::predictEncode(static_cast<char*>(*buf), nbytes, cd);
+      // the size is not changed by this filter: reuse the buffer
+      memcpy(*buf, out.data(), out.size());
+      return out.size();
+    }
+    catch(...) {
+      return 0;
+    }
+  }
+
+  herr_t setLocal(hid_t dcpl, hid_t type, hid_t) {
+    unsigned int flags;
+    size_t nCdValues=0;
+    if(H5Pget_filter_by_id2(dcpl, H5::predictFilterID, &flags, &nCdValues, nullptr, 0, nullptr, nullptr)<0)
+      return -1;
+    // the two modes, the element size, the number of columns per chunk and the optional modes per column
+    vector<unsigned int> cdValues(max<size_t>(nCdValues, 4), 0);
+    if(H5Pget_filter_by_id2(dcpl, H5::predictFilterID, &flags, &nCdValues, cdValues.data(), 0, nullptr, nullptr)<0)
+      return -1;
+    hsize_t chunkDims[32];
+    int rank=H5Pget_chunk(dcpl, 32, chunkDims);
+    if(rank<1)
+      return -1;
+    size_t elemSize=H5Tget_size(type);
+    // elements larger than 8 bytes are not predicted
+    cdValues[2]=elemSize<=8 ? elemSize : 1;
+    cdValues[3]=elemSize<=8 ? chunkDims[rank-1] : chunkDims[rank-1]*elemSize;
+    if(elemSize>8) {
+      cdValues[0]=cdValues[1]=H5::predictNone;
+      cdValues.resize(4);
+    }
+    if(cdValues.size()>4 && cdValues.size()!=4+cdValues[3])
+      return -1;
+    return H5Pmodify_filter(dcpl, H5::predictFilterID, flags, cdValues.size(), cdValues.data());
+  }
+
+}
+
+namespace H5 {
+
+void registerPredictFilter() {
+  static bool registered=false;
+  if(registered)
+    return;
+  H5Z_class2_t filterClass {
+    H5Z_CLASS_T_VERS,
+    predictFilterID,
+    1, 1,
+    "hdf5serie predictive filter",
+    nullptr,
+    &setLocal,
+    &filter
+  };
+  if(H5Zregister(&filterClass)<0)
+    throw runtime_error("Registering the predictive filter failed.");
+  registered=true;
+}
+
+vector<char> predictEncode(const char *data, size_t size, const vector<unsigned int> &cdValues) {
+  Layout l=getLayout(size, cdValues);
+  vector<char> out(size);
+  vector<uint64_t> res(l.rows);
+  for(size_t c=0; c<l.cols; ++c) {
+    int mode=l.mode[c];
+    uint64_t prev=0;
+    for(size_t r=0; r<l.rows; ++r) {
+      uint64_t v=load(data+(r*l.cols+c)*l.elemSize, l.elemSize);
+      res[r]=mode==predictDelta ? v-prev : (mode==predictXOR ? v^prev : v);
+      prev=v;
+    }
+    // write the byte planes
+    unsigned char *plane=reinterpret_cast<unsigned char*>(out.data())+c*l.elemSize*l.rows;
+    for(size_t b=0; b<l.elemSize; ++b, plane+=l.rows)
+      for(size_t r=0; r<l.rows; ++r)
+        plane[r]=static_cast<unsigned char>(res[r]>>(8*b));
+  }
+  // trailing bytes are not transformed
+  size_t body=l.rows*l.cols*l.elemSize;
+  memcpy(out.data()+body, data+body, size-body);
+  return out;
+}
+
+vector<char> predictDecode(const char *data, size_t size, const vector<unsigned int> &cdValues) {
+  Layout l=getLayout(size, cdValues);
+  vector<char> out(size);
+  vector<uint64_t> res(l.rows);
+  uint64_t mask=l.elemSize==8 ? ~uint64_t(0) : (uint64_t(1)<<(8*l.elemSize))-1;
+  for(size_t c=0; c<l.cols; ++c) {
+    int mode=l.mode[c];
+    // read the byte planes
+    const unsigned char *plane=reinterpret_cast<const unsigned char*>(data)+c*l.elemSize*l.rows;
+    fill(res.begin(), res.end(), 0);
+    for(size_t b=0; b<l.elemSize; ++b, plane+=l.rows)
+      for(size_t r=0; r<l.rows; ++r)
+        res[r]|=static_cast<uint64_t>(plane[r])<<(8*b);
+    uint64_t prev=0;
+    for(size_t r=0; r<l.rows; ++r) {
+      uint64_t v=(mode==predictDelta ? res[r]+prev : (mode==predictXOR ? res[r]^prev : res[r])) & mask;
+      prev=v;
+      store(out.data()+(r*l.cols+c)*l.elemSize, l.elemSize, v);
+    }
+  }
+  size_t body=l.rows*l.cols*l.elemSize;
+  memcpy(out.data()+body, data+body, size-body);
+  return out;
+}
+
+}
@@ -0,0 +1,51 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#ifndef _HDF5SERIE_PREDICTFILTER_H_
+#define _HDF5SERIE_PREDICTFILTER_H_
+
+#include <hdf5.h>
+#include <hdf5serie/vectorserie.h>
+#include <vector>
+
+namespace H5 {
+
+// The predictive filter of this library, see VectorSerieOptions::predictiveFilter.
+// Each element of a chunk (row-major, rows x cols elements of elemSize bytes, interpreted as little endian unsigned
+// integer) is replaced by its prediction residual with respect to the element of the previous row in the same column:
+// the difference (delta coding, good for monotone values like time) or the XOR (good for smooth floating point signals).
+// The residuals are then stored as byte planes per column (all bytes 0 of column 0, all bytes 1 of column 0, ...),
+// such that the (mostly zero) high bytes are contiguous for the following compression filter.
+// The filter parameters (cd_values) are: the mode (PredictMode) of column 0 of the chunk, the mode of all other columns,
+// the element size and the number of columns per chunk (the last two are set automatically when the dataset is created),
+// optionally followed by the mode of each column of the chunk (then the first two modes are ignored).
+// The filter id is in the range for private filters (not registered at The HDF Group).
+const H5Z_filter_t predictFilterID=32768;
+
+// register the filter in the HDF5 library (if not already done)
+void registerPredictFilter();
+
+std::vector<char> predictEncode(const char *data, size_t size, const std::vector<unsigned int> &cdValues);
+std::vector<char> predictDecode(const char *data, size_t size, const std::vector<unsigned int> &cdValues);
+
+}
+
+#endif
@@ -0,0 +1,188 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include "pyramid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace H5 {
+
+Pyramid::Pyramid(int cols_, int factor_, int levels_) : cols(cols_), factor(factor_), levels(levels_) {
+  if(factor<2 || levels<1)
+    throw runtime_error("A pyramid needs a factor >= 2 and at least one level.");
+  blockRows.resize(levels+1);
+  blockRows[0]=1;
+  for(int l=1; l<=levels; ++l)
+    blockRows[l]=blockRows[l-1]*factor;
+  block.resize(levels+1);
+  for(auto &b : block) {
+    b.min.resize(cols, numeric_limits<double>::infinity());
+    b.max.resize(cols, -numeric_limits<double>::infinity());
+    b.sum.resize(cols, 0);
+  }
+}
+
+Pyramid::Pyramid(hid_t parent, const string &name, int cols_, int factor_, int levels_, hsize_t chunkRows, int compression) :
+  Pyramid(cols_, factor_, levels_) {
+  for(int l=1; l<=levels; ++l)
+    level.emplace_back(new CompanionDataset(parent, CompanionDataset::getName(name, "pyramid"+to_string(l)), 3*cols, chunkRows, compression, 3));
+  level[0]->setAttribute("Factor", factor);
+  level[0]->setAttribute("Levels", levels);
+}
+
+shared_ptr<Pyramid> Pyramid::open(hid_t parent, const string &name) {
+  string name1=CompanionDataset::getName(name, "pyramid1");
+  if(!CompanionDataset::exists(parent, name1))
+    return nullptr;
+  auto level1=make_unique<CompanionDataset>(parent, name1);
+  shared_ptr<Pyramid> p(new Pyramid(level1->getColumns()/3, level1->getAttribute("Factor"), level1->getAttribute("Levels")));
+  p->level.emplace_back(std::move(level1));
+  for(int l=2; l<=p->levels; ++l)
+    p->level.emplace_back(new CompanionDataset(parent, CompanionDataset::getName(name, "pyramid"+to_string(l))));
+  return p;
+}
+
+void Pyramid::close() {
+  for(auto &l : level)
+    l->close();
+}
+
+void Pyramid::reopen(hid_t parent) {
+  for(auto &l : level)
+    l->reopen(parent);
+}
+
+void Pyramid::flush() {
+  for(auto &l : level)
+    l->flush();
+}
+
+void Pyramid::refresh() {
+  for(auto &l : level)
+    l->refresh();
+}
+
+void Pyramid::append(const double *row) {
+  add(1, row, row, row, 1);
+}
+
+void Pyramid::add(int l, const double *min, const double *max, const double *sum, hsize_t rows) {
+  Block &b=block[l];
+  for(int c=0; c<cols; ++c) {
+    // NaN values are ignored by min and max but not by the mean (isless/isgreater do not raise FE_INVALID on NaN)
+    if(isless(min[c], b.min[c])) b.min[c]=min[c];
+    if(isgreater(max[c], b.max[c])) b.max[c]=max[c];
+    b.sum[c]+=sum[c];
+  }
+  b.rows+=rows;
+  if(b.rows<blockRows[l])
+    return;
+
+  // the block is complete: write it and add it to the next level
+  vector<double> data(3*cols);
+  for(int c=0; c<cols; ++c) {
+    data[3*c+0]=b.min[c];
+    data[3*c+1]=b.max[c];
+    data[3*c+2]=b.sum[c]/b.rows;
+  }
+  level[l-1]->append(data.data());
+  if(l<levels)
+    add(l+1, b.min.data(), b.max.data(), b.sum.data(), b.rows);
+  fill(b.min.begin(), b.min.end(), numeric_limits<double>::infinity());
+  fill(b.max.begin(), b.max.end(), -numeric_limits<double>::infinity());
+  fill(b.sum.begin(), b.sum.end(), 0);
+  b.rows=0;
+}
+
+Envelope Pyramid::getEnvelope(Pyramid *pyramid, int column, hsize_t startRow, hsize_t endRow, hsize_t points,
+                              const function<vector<double>(hsize_t, hsize_t)> &readRaw) {
+  Envelope env;
+  if(endRow<=startRow)
+    return env;
+  points=max<hsize_t>(points, 1);
+  hsize_t binRows=(endRow-startRow+points-1)/points;
+
+  // use the coarsest level with blocks not larger than a bin and use the finer levels (and the raw data)
+  // for the rows at the begin and end of the range not covered by complete blocks
+  int topLevel=0;
+  while(pyramid && topLevel<pyramid->levels && pyramid->blockRows[topLevel+1]<=binRows)
+    topLevel++;
+  // align the bins to multiples of binRows being a multiple of the block size: no block is split between two bins
+  hsize_t n=pyramid ? pyramid->blockRows[topLevel] : 1;
+  binRows=(binRows+n-1)/n*n;
+  hsize_t firstBin=startRow/binRows;
+  size_t nBins=(endRow-1)/binRows-firstBin+1;
+  env.firstRow.resize(nBins);
+  env.rows.resize(nBins);
+  env.min.resize(nBins, numeric_limits<double>::infinity());
+  env.max.resize(nBins, -numeric_limits<double>::infinity());
+  env.mean.resize(nBins, 0);
+  for(size_t i=0; i<nBins; ++i) {
+    env.firstRow[i]=max(startRow, (firstBin+i)*binRows);
+    env.rows[i]=min(endRow, (firstBin+i+1)*binRows)-env.firstRow[i];
+  }
+  // add the values of rows [firstRow, firstRow+rows[ to its bin
+  auto addToBin=[&](hsize_t firstRow, hsize_t rows, double mn, double mx, double mean) {
+    size_t i=firstRow/binRows-firstBin;
+    if(isless(mn, env.min[i])) env.min[i]=mn;
+    if(isgreater(mx, env.max[i])) env.max[i]=mx;
+    env.mean[i]+=mean*rows;
+  };
+
+  function<void(int, hsize_t, hsize_t)> collect=[&](int l, hsize_t begin, hsize_t end) {
+    if(begin>=end)
+      return;
+    if(l==0) {
+      vector<double> raw=readRaw(begin, end);
+      for(hsize_t r=begin; r<end; ++r)
+        addToBin(r, 1, raw[r-begin], raw[r-begin], raw[r-begin]);
+      return;
+    }
+    hsize_t n=pyramid->blockRows[l];
+    hsize_t firstBlock=(begin+n-1)/n;
+    hsize_t endBlock=min(end/n, pyramid->level[l-1]->getRows());
+    if(firstBlock>=endBlock) {
+      collect(l-1, begin, end);
+      return;
+    }
+    collect(l-1, begin, firstBlock*n);
+    vector<double> data=pyramid->level[l-1]->read(firstBlock, endBlock-firstBlock, 3*column, 1, 3);
+    for(hsize_t b=firstBlock; b<endBlock; ++b) {
+      const double *d=&data[3*(b-firstBlock)];
+      addToBin(b*n, n, d[0], d[1], d[2]);
+    }
+    collect(l-1, endBlock*n, end);
+  };
+  collect(topLevel, startRow, endRow);
+
+  for(size_t i=0; i<nBins; ++i) {
+    env.mean[i]/=env.rows[i];
+    if(env.min[i]>env.max[i]) // only NaN values
+      env.min[i]=env.max[i]=numeric_limits<double>::quiet_NaN();
+  }
+  return env;
+}
+
+}
@@ -0,0 +1,79 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#ifndef _HDF5SERIE_PYRAMID_H_
+#define _HDF5SERIE_PYRAMID_H_
+
+#include <hdf5serie/vectorserie.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "companiondataset.h"
+
+namespace H5 {
+
+// A min/max/mean pyramid of a VectorSerie, see VectorSerie::enablePyramid.
+// Level l (1<=l<=levels) holds one row for each complete block of factor^l rows of the serie: the min, the max and the
+// mean value of each column (3*cols columns, like a ZoneMap). Each level is stored as a CompanionDataset with the kind
+// "pyramid<l>" chunked per column, so the envelope of a column reads only the chunks of this column. The pyramid is updated row by row on the writer side; incomplete blocks are not written.
+class Pyramid {
+  public:
+    // create a new pyramid for the serie name in parent
+    Pyramid(hid_t parent, const std::string &name, int cols_, int factor_, int levels_, hsize_t chunkRows, int compression);
+    // open the pyramid of the serie name in parent; nullptr if the serie has no pyramid
+    static std::shared_ptr<Pyramid> open(hid_t parent, const std::string &name);
+
+    void close();
+    void reopen(hid_t parent);
+    void flush();
+    void refresh();
+
+    int getFactor() { return factor; }
+    int getLevels() { return levels; }
+
+    // add a row of the serie
+    void append(const double *row);
+
+    // see VectorSerie::getEnvelope; readRaw(begin, end) must return the values of the column for the rows [begin, end[
+    // pyramid may be nullptr: then only readRaw is used
+    static Envelope getEnvelope(Pyramid *pyramid, int column, hsize_t startRow, hsize_t endRow, hsize_t points,
+                         const std::function<std::vector<double>(hsize_t, hsize_t)> &readRaw);
+
+  private:
+    Pyramid(int cols_, int factor_, int levels_);
+    int cols;
+    int factor;
+    int levels;
+    std::vector<std::unique_ptr<CompanionDataset>> level; // level[l-1] is level l
+    std::vector<hsize_t> blockRows; // blockRows[l] = factor^l
+    // the incomplete block of each level (writer side)
+    struct Block {
+      std::vector<double> min, max, sum;
+      hsize_t rows { 0 };
+    };
+    std::vector<Block> block;
+    void add(int l, const double *min, const double *max, const double *sum, hsize_t rows);
+};
+
+}
+
+#endif
@@ -0,0 +1,107 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include "quantize.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+namespace H5 {
+
+namespace {
+
+template<class T, class UInt>
+void roundMantissaImpl(T *data, size_t size, int keepBits, int mantissaBits) {
+  int drop=mantissaBits-keepBits;
+  if(drop<=0)
+    return;
+  UInt half=UInt(1)<<(drop-1);
+  UInt mask=~((UInt(1)<<drop)-1);
+  for(size_t i=0; i<size; ++i) {
+    if(!isfinite(data[i]))
+      continue;
+    UInt u;
+    memcpy(&u, &data[i], sizeof(T));
+    // a carry into the exponent rounds up to the next power of two, which is the correct result
+    UInt r=(u+half)&mask;
+    T v;
+    memcpy(&v, &r, sizeof(T));
+    if(!isfinite(v)) { // rounding up the largest values overflows: truncate instead
+      r=u&mask;
+      memcpy(&v, &r, sizeof(T));
+    }
+    data[i]=v;
+  }
+}
+
+template<class T>
+void quantizeImpl(T *data, size_t size, double step) {
+  int stepExp;
+  frexp(step, &stepExp);
+  for(size_t i=0; i<size; ++i) {
+    if(!isfinite(data[i]))
+      continue;
+    // values with |v| >= step*2^digits are already a multiple of step (and v/step may overflow): keep them
+    int exp;
+    frexp(data[i], &exp);
+    if(exp-stepExp>=numeric_limits<T>::digits)
+      continue;
+    data[i]=static_cast<T>(nearbyint(data[i]/step)*step);
+  }
+}
+
+}
+
+int getKeepBits(double relativeError, int mantissaBits) {
+  // rounding to k mantissa bits has a relative error <= 2^-(k+1)
+  if(!(relativeError>0))
+    return mantissaBits;
+  double k=ceil(-log2(relativeError))-1;
+  return static_cast<int>(max(0.0, min<double>(mantissaBits, k)));
+}
+
+void roundMantissa(double *data, size_t size, int keepBits) {
+  roundMantissaImpl<double, uint64_t>(data, size, keepBits, 52);
+}
+
+void roundMantissa(float *data, size_t size, int keepBits) {
+  roundMantissaImpl<float, uint32_t>(data, size, keepBits, 23);
+}
+
+double getQuantizationStep(double absoluteError) {
+  // rounding to a multiple of step has a error <= step/2
+  return exp2(floor(log2(2*absoluteError)));
+}
+
+void quantize(double *data, size_t size, double step) {
+  quantizeImpl(data, size, step);
+}
+
+void quantize(float *data, size_t size, double step) {
+  quantizeImpl(data, size, step);
+}
+
+}
@@ -0,0 +1,50 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#ifndef _HDF5SERIE_QUANTIZE_H_
+#define _HDF5SERIE_QUANTIZE_H_
+
+#include <cstddef>
+
+namespace H5 {
+
+// Lossy rounding of floating point values, see VectorSerieOptions::relativeError and VectorSerieOptions::absoluteError.
+// The rounded values have many trailing zero bits which are compressed well by the following compression filter.
+// No filter is needed to read the values.
+
+// Returns the number of mantissa bits to keep such that the relative rounding error is <= relativeError
+// (clamped to the mantissa size mantissaBits of the type).
+int getKeepBits(double relativeError, int mantissaBits);
+
+// Rounds the mantissa of all finite values of data to keepBits bits (round half away from zero).
+void roundMantissa(double *data, size_t size, int keepBits);
+void roundMantissa(float *data, size_t size, int keepBits);
+
+// Returns the largest power of two step such that rounding to a multiple of step has a error <= absoluteError.
+double getQuantizationStep(double absoluteError);
+
+// Rounds all values of data to the nearest multiple of step (values too large to have a fraction of step are kept).
+void quantize(double *data, size_t size, double step);
+void quantize(float *data, size_t size, double step);
+
+}
+
+#endif
@@ -0,0 +1,175 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+#include <config.h>
+#include <hdf5serie/rowcursor.h>
+#include <hdf5serie/toh5type.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include "chunkcodec.h"
+#include "threadpool.h"
+
+using namespace std;
+
+namespace H5 {
+
+  // read access to the raw bytes of the HDF5 file (shared by all background reads of a cursor)
+  template<class T>
+  struct RowCursor<T>::Reader {
+    ifstream file;
+    mutex m;
+    vector<char> read(haddr_t addr, hsize_t size) {
+      vector<char> data(size);
+      scoped_lock lock(m);
+      file.seekg(addr);
+      file.read(data.data(), size);
+      if(!file)
+        throw runtime_error("Reading a chunk from the file failed.");
+      return data;
+    }
+  };
+
+  template<class T>
+  RowCursor<T>::RowCursor(VectorSerie<T> *vs_, int readAhead_, int startRow, int endRow_) : vs(vs_), readAhead(max(readAhead_, 0)) {
+    int rows=vs->getRows();
+    int end=endRow_<0 ? rows : min(endRow_, rows);
+    if(startRow<0 || startRow>end)
+      throw Exception(vs->getPath(), "The start row "+to_string(startRow)+" of the cursor is out of range [0.."+to_string(end)+"].");
+    endRow=end;
+    row=startRow;
+    nextChunkRow=startRow;
+    cols=vs->getColumns();
+    hid_t id=vs->getID();
+    ScopedHID cpl(H5Dget_create_plist(id), &H5Pclose);
+    hsize_t chunkDims[2];
+    H5Pget_chunk(cpl, 2, chunkDims);
+    chunkRows=chunkDims[0];
+
+#if H5_VERSION_GE(1, 10, 5)
+    // check if read-ahead is possible
+    ScopedHID ftype(H5Dget_type(id), &H5Tclose);
+    T dummy;
+    auto c=make_shared<ChunkCodec>(cpl);
+    if(vs->getFile()->getType()==File::read && chunkDims[1]==cols && H5Tequal(ftype, toH5Type(dummy))>0 && c->isSupported()) {
+      reader=make_shared<Reader>();
+      reader->file.open(vs->getFile()->getName(), ios::binary);
+      if(reader->file)
+        codec=c;
+    }
+#endif
+    schedule();
+  }
+
+  template<class T>
+  RowCursor<T>::~RowCursor() {
+    // wait for all background reads (they do not access this object but use worker threads)
+    for(auto &c : pending)
+      if(c.data.valid())
+        c.data.wait();
+  }
+
+  template<class T>
+  void RowCursor<T>::schedule() {
+    while(pending.size()<static_cast<size_t>(readAhead)+1 && nextChunkRow<endRow) {
+      Chunk c;
+      c.firstRow=nextChunkRow;
+      hsize_t chunkStart=nextChunkRow/chunkRows*chunkRows;
+      hsize_t chunkEnd=min(chunkStart+chunkRows, endRow);
+      c.rows=chunkEnd-nextChunkRow;
+      nextChunkRow=chunkEnd;
+#if H5_VERSION_GE(1, 10, 5)
+      // complete chunks are read in the background (incomplete ones may still be changed by a writer)
+      if(codec && chunkStart+chunkRows<=static_cast<hsize_t>(vs->getRows())) {
+        hsize_t offset[]={chunkStart, 0};
+        unsigned filterMask=0;
+        haddr_t addr=HADDR_UNDEF;
+        hsize_t size=0;
+        if(H5Dget_chunk_info_by_coord(vs->getID(), offset, &filterMask, &addr, &size)>=0 && addr!=HADDR_UNDEF) {
+          c.firstRow=chunkStart;
+          size_t rawSize=chunkRows*cols*sizeof(T);
+          c.data=ThreadPool::global()->submit([reader=reader, codec=codec, addr, size, filterMask, rawSize]() {
+            return codec->decode(reader->read(addr, size), filterMask, rawSize);
+          });
+        }
+      }
+#endif
+      pending.emplace_back(std::move(c));
+    }
+  }
+
+  template<class T>
+  bool RowCursor<T>::next() {
+    if(started)
+      row++;
+    started=true;
+    if(row>=endRow)
+      return false;
+    if(row<currentEndRow)
+      return true;
+
+    // move to the next chunk
+    if(pending.empty())
+      return false;
+    auto start=chrono::steady_clock::now();
+    bool stall;
+    Chunk c=std::move(pending.front());
+    pending.pop_front();
+    if(c.data.valid()) {
+      stall=c.data.wait_for(chrono::seconds(0))!=future_status::ready;
+      current=c.data.get();
+      currentFirstRow=c.firstRow;
+      currentEndRow=min(c.firstRow+chunkRows, endRow);
+    }
+    else {
+      // no read-ahead possible for this chunk: read it now
+      stall=true;
+      current.resize(c.rows*cols*sizeof(T));
+      vs->getRowRange(c.firstRow, c.rows, c.rows*cols, reinterpret_cast<T*>(current.data()));
+      currentFirstRow=c.firstRow;
+      currentEndRow=c.firstRow+c.rows;
+    }
+    schedule();
+    stats.chunks++;
+    if(stall) {
+      double t=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+      stats.stalls++;
+      stats.stallTime+=t;
+      stats.maxStallTime=max(stats.maxStallTime, t);
+    }
+    return true;
+  }
+
+  template<class T>
+  Span<const T> RowCursor<T>::getRow() {
+    if(!started || row>=endRow)
+      throw Exception(vs->getPath(), "The cursor is not at a valid row.");
+    return Span<const T>(reinterpret_cast<const T*>(current.data())+(row-currentFirstRow)*cols, cols);
+  }
+
+  // explizit template instantations
+
+# define FOREACHKNOWNTYPE(CTYPE, H5TYPE) \
+  template class RowCursor<CTYPE>;
+# include "hdf5serie/knownpodtypes.def"
+# undef FOREACHKNOWNTYPE
+
+}
@@ -0,0 +1,111 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+#ifndef _HDF5SERIE_ROWCURSOR_H_
+#define _HDF5SERIE_ROWCURSOR_H_
+
+#include <hdf5serie/vectorserie.h>
+#include <hdf5serie/span.h>
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace H5 {
+
+  class ChunkCodec;
+
+  /** \brief Sequential row by row read access to a VectorSerie with read-ahead.
+   *
+   * While the caller consumes the rows of the current chunk the next chunks are read and decompressed
+   * in the background by the worker threads of this library (see File::setNumberOfWorkerThreads).
+   * The background read is done by reading the file directly at the chunk addresses (which are resolved by HDF5),
+   * since HDF5 itself is not thread-safe. This is only possible for complete chunks of datasets of files opened
+   * for reading, with chunks covering all columns, a file datatype equal to the native datatype of T and filters
+   * known by this library (deflate, shuffle and the predictive filter) and requires HDF5 >= 1.10.5.
+   * All other chunks are read by HDF5 when they are needed (without read-ahead).
+   *
+   * Usage:
+   * \code
+   * RowCursor<double> cursor(vs);
+   * while(cursor.next()) {
+   *   Span<const double> row=cursor.getRow();
+   *   ...
+   * }
+   * \endcode
+   */
+  template<class T>
+  class RowCursor {
+    public:
+      //! Statistics of the time the caller had to wait for chunks.
+      struct Stats {
+        size_t chunks { 0 }; //!< number of chunks consumed
+        size_t stalls { 0 }; //!< number of chunks which were not ready when they were needed
+        double stallTime { 0 }; //!< total time (in seconds) waited for chunks
+        double maxStallTime { 0 }; //!< longest time (in seconds) waited for a single chunk
+      };
+
+      /** Iterate over the rows [startRow, endRow[ of \a vs_ (endRow<0 means up to the current number of rows).
+       * \a readAhead_ is the number of chunks read ahead of the current one (negative values are handled as 0).
+       * Throws if \a startRow is negative or behind the end row.
+       */
+      RowCursor(VectorSerie<T> *vs_, int readAhead_=2, int startRow=0, int endRow=-1);
+      ~RowCursor();
+
+      //! Move to the next row (the first call moves to the first row). Returns false if no more row exists.
+      bool next();
+
+      //! Returns the current row number.
+      int getRowNumber() { return row; }
+
+      //! Returns a view of the current row (of size getColumns() of the VectorSerie).
+      //! The view is valid until the next call of next().
+      Span<const T> getRow();
+
+      const Stats& getStats() { return stats; }
+
+    private:
+      struct Reader;
+      struct Chunk {
+        hsize_t firstRow; // first row of data
+        hsize_t rows; // number of rows to read by HDF5, only used if data is not valid (no read-ahead)
+        std::future<std::vector<char>> data; // the decoded chunk (if valid)
+      };
+      VectorSerie<T> *vs;
+      int readAhead;
+      hsize_t endRow;
+      hsize_t cols;
+      hsize_t chunkRows;
+      hsize_t row;
+      bool started { false };
+      std::shared_ptr<ChunkCodec> codec; // nullptr if no read-ahead is possible
+      std::shared_ptr<Reader> reader;
+      hsize_t nextChunkRow; // the first row of the next chunk to schedule
+      std::deque<Chunk> pending;
+      std::vector<char> current; // the data of the current chunk
+      hsize_t currentFirstRow { 0 };
+      hsize_t currentEndRow { 0 };
+      Stats stats;
+      void schedule();
+  };
+
+}
+
+#endif
@@ -0,0 +1,51 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#ifndef _HDF5SERIE_SPAN_H_
+#define _HDF5SERIE_SPAN_H_
+
+#include <cstddef>
+
+namespace H5 {
+
+  /** \brief A view of contiguous elements which are not owned by the view.
+   *
+   * A minimal replacement of the C++20 std::span (this library is C++17).
+   */
+  template<class T>
+  class Span {
+    public:
+      Span() = default;
+      Span(T *data_, size_t size_) : d(data_), s(size_) {}
+      T* data() const { return d; }
+      size_t size() const { return s; }
+      bool empty() const { return s==0; }
+      T& operator[](size_t i) const { return d[i]; }
+      T* begin() const { return d; }
+      T* end() const { return d+s; }
+    private:
+      T *d { nullptr };
+      size_t s { 0 };
+  };
+
+}
+
+#endif
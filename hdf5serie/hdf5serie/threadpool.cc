@@ -0,0 +1,67 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include "threadpool.h"
+#include <hdf5serie/file.h>
+
+using namespace std;
+
+namespace H5 {
+
+ThreadPool::ThreadPool(int n) {
+  for(int i=0; i<n; ++i)
+    threads.emplace_back([this](){
+      while(true) {
+        function<void()> task;
+        {
+          unique_lock lock(mutex);
+          cond.wait(lock, [this](){ return stop || !tasks.empty(); });
+          if(stop && tasks.empty())
+            return;
+          task=std::move(tasks.front());
+          tasks.pop();
+        }
+        task();
+      }
+    });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    scoped_lock lock(mutex);
+    stop=true;
+  }
+  cond.notify_all();
+  for(auto &t : threads)
+    t.join();
+}
+
+shared_ptr<ThreadPool> ThreadPool::global() {
+  static shared_ptr<ThreadPool> pool;
+  static std::mutex poolMutex;
+  scoped_lock lock(poolMutex);
+  if(!pool || pool->size()!=File::getNumberOfWorkerThreads())
+    pool=make_shared<ThreadPool>(File::getNumberOfWorkerThreads());
+  return pool;
+}
+
+}
@@ -0,0 +1,72 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#ifndef _HDF5SERIE_THREADPOOL_H_
+#define _HDF5SERIE_THREADPOOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace H5 {
+
+// A simple pool of worker threads.
+// Note: the HDF5 library is not thread-safe: tasks must not call any HDF5 function.
+class ThreadPool {
+  public:
+    ThreadPool(int n);
+    // finishes all queued tasks before returning
+    ~ThreadPool();
+
+    int size() const { return threads.size(); }
+
+    template<class F>
+    std::future<std::invoke_result_t<F>> submit(F func) {
+      auto task=std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::move(func));
+      auto ret=task->get_future();
+      {
+        std::scoped_lock lock(mutex);
+        tasks.emplace([task](){ (*task)(); });
+      }
+      cond.notify_one();
+      return ret;
+    }
+
+    // the thread pool used by this library, with File::getNumberOfWorkerThreads() threads
+    static std::shared_ptr<ThreadPool> global();
+
+  private:
+    std::vector<std::thread> threads;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool stop { false };
+};
+
+}
+
+#endif
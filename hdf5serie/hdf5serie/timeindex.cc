@@ -0,0 +1,108 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include "timeindex.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace H5 {
+
+TimeIndex::TimeIndex(hid_t parent, const string &name, int column_, hsize_t chunkRows_) : TimeIndex(column_, chunkRows_) {
+  ds.reset(new CompanionDataset(parent, CompanionDataset::getName(name, "timeindex"), 2, chunkRows, 0));
+  ds->setAttribute("Column", column);
+}
+
+shared_ptr<TimeIndex> TimeIndex::open(hid_t parent, const string &name, hsize_t chunkRows_) {
+  string dsName=CompanionDataset::getName(name, "timeindex");
+  if(!CompanionDataset::exists(parent, dsName))
+    return nullptr;
+  auto ds=make_unique<CompanionDataset>(parent, dsName);
+  shared_ptr<TimeIndex> index(new TimeIndex(ds->getAttribute("Column"), chunkRows_));
+  index->ds=std::move(ds);
+  return index;
+}
+
+void TimeIndex::close() {
+  ds->close();
+}
+
+void TimeIndex::reopen(hid_t parent) {
+  ds->reopen(parent);
+}
+
+void TimeIndex::flush() {
+  ds->flush();
+}
+
+void TimeIndex::refresh() {
+  ds->refresh();
+}
+
+void TimeIndex::append(hsize_t row, double value) {
+  if(row%chunkRows==0)
+    chunkFirst=value;
+  if(row%chunkRows==chunkRows-1) {
+    double entry[]={chunkFirst, value};
+    ds->append(entry);
+    first.push_back(entry[0]);
+    last.push_back(entry[1]);
+  }
+}
+
+hsize_t TimeIndex::partitionPoint(TimeIndex *index, hsize_t rows, hsize_t chunkRows, const function<bool(double)> &pred,
+                                  const ReadColumn &readColumn) {
+  hsize_t begin=0, end=rows;
+  if(index) {
+    // update the cache with the new index entries in the file (entries written by this process are already cached)
+    hsize_t n=index->ds->getRows();
+    if(n>index->first.size()) {
+      vector<double> data=index->ds->read(index->first.size(), n-index->first.size(), 0, 1, 2);
+      for(size_t i=0; i<data.size(); i+=2) {
+        index->first.push_back(data[i]);
+        index->last.push_back(data[i+1]);
+      }
+    }
+    // the first chunk with a last value not fulfilling pred contains the partition point
+    hsize_t nChunks=min<hsize_t>(index->last.size(), rows/chunkRows);
+    hsize_t c=partition_point(index->last.begin(), index->last.begin()+nChunks, pred)-index->last.begin();
+    begin=c*chunkRows;
+    if(c<nChunks) {
+      // the values of all previous chunks fulfill pred: if the first value of this chunk does not, no row must be read
+      if(!pred(index->first[c]))
+        return begin;
+      end=begin+chunkRows;
+    }
+  }
+  // binary search using single values until the range is small, then read the range
+  while(end-begin>chunkRows) {
+    hsize_t mid=begin+(end-begin)/2;
+    if(pred(readColumn(mid, mid+1)[0]))
+      begin=mid+1;
+    else
+      end=mid;
+  }
+  vector<double> data=readColumn(begin, end);
+  return begin+(partition_point(data.begin(), data.end(), pred)-data.begin());
+}
+
+}
@@ -0,0 +1,71 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#ifndef _HDF5SERIE_TIMEINDEX_H_
+#define _HDF5SERIE_TIMEINDEX_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "companiondataset.h"
+
+namespace H5 {
+
+// A sparse index of a nondecreasing (time) column of a VectorSerie, see VectorSerie::enableTimeIndex.
+// For each complete chunk of the serie the first and the last value of the column is stored in a CompanionDataset
+// with the kind "timeindex". The index is updated row by row on the writer side and cached on the reader side.
+class TimeIndex {
+  public:
+    // create a new index of column column_ for the serie name in parent with chunks of chunkRows_ rows
+    TimeIndex(hid_t parent, const std::string &name, int column_, hsize_t chunkRows_);
+    // open the index of the serie name in parent; nullptr if the serie has no index
+    static std::shared_ptr<TimeIndex> open(hid_t parent, const std::string &name, hsize_t chunkRows_);
+
+    void close();
+    void reopen(hid_t parent);
+    void flush();
+    void refresh();
+
+    int getColumn() { return column; }
+
+    // add the value of the index column of the row row of the serie (rows must be added in order)
+    void append(hsize_t row, double value);
+
+    // returns the first row of [0, rows[ for which pred(value) is false (pred must be true for a prefix of the rows);
+    // readColumn(begin, end) must return the values of the index column of the rows [begin, end[.
+    // index may be nullptr: then a binary search on the column is done.
+    using ReadColumn = std::function<std::vector<double>(hsize_t, hsize_t)>;
+    static hsize_t partitionPoint(TimeIndex *index, hsize_t rows, hsize_t chunkRows, const std::function<bool(double)> &pred,
+                                  const ReadColumn &readColumn);
+
+  private:
+    TimeIndex(int column_, hsize_t chunkRows_) : column(column_), chunkRows(chunkRows_) {}
+    int column;
+    hsize_t chunkRows;
+    std::unique_ptr<CompanionDataset> ds;
+    double chunkFirst { 0 }; // the first value of the current chunk (writer side)
+    std::vector<double> first, last; // the cached index
+};
+
+}
+
+#endif
@@ -23,11 +23,21 @@
 #include <hdf5serie/vectorserie.h>
 #include <hdf5serie/simpleattribute.h>
 #include <hdf5serie/toh5type.h>
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 #include "utils.h"
+#include "chunkcodec.h"
+#include "threadpool.h"
+#include "pyramid.h"
+#include "timeindex.h"
+#include "zonemap.h"
+#include "predictfilter.h"
+#include "quantize.h"
 
 using namespace std;
 
@@ -43,9 +53,17 @@ namespace H5 {
   }
 
   template<class T>
-  VectorSerie<T>::VectorSerie(GroupBase *parent_, const string &name_, int cols, int compression, int chunkSize) : Dataset(parent_, name_) {
+  VectorSerie<T>::VectorSerie(GroupBase *parent_, const string &name_, int cols, int compression, int chunkSize,
+                              int columnsPerChunk) :
+    VectorSerie(parent_, name_, cols, VectorSerieOptions(compression, chunkSize, columnsPerChunk)) {
+  }
+
+  template<class T>
+  VectorSerie<T>::VectorSerie(GroupBase *parent_, const string &name_, int cols, const VectorSerieOptions &options) :
+    Dataset(parent_, name_) {
     T dummy;
     memDataTypeID=toH5Type(dummy);
+    initLossy(options.relativeError, options.absoluteError);
     // create dataset with chunk cache size = chunk size
     dims[0]=0;
     dims[1]=cols;
@@ -53,16 +71,36 @@ namespace H5 {
     ScopedHID fileDataSpaceID(H5Screate_simple(2, dims, maxDims), &H5Sclose);
     ScopedHID propID(H5Pcreate(H5P_DATASET_CREATE), &H5Pclose);
     H5Pset_attr_phase_change(propID, 0, 0);
-    hsize_t chunkDims[]={(hsize_t)chunkSize, (hsize_t)(dims[1])};
+    chunkDims[0]=options.chunkSize;
+    chunkDims[1]=options.columnsPerChunk>0 ? min<hsize_t>(options.columnsPerChunk, dims[1]) : dims[1];
     H5Pset_chunk(propID, 2, chunkDims);
-    if(compression>0) H5Pset_deflate(propID, compression);
+    if(options.predictiveFilter && memDataTypeID!=returnVarLenStrDatatypeID()) {
+      // the element size and the chunk width are set by the filter itself
+      vector<unsigned int> cdValues{predictDelta, predictXOR};
+      if(!options.predictModes.empty()) {
+        auto mode=[&options](hsize_t c) { return c<options.predictModes.size() ? options.predictModes[c] : predictXOR; };
+        cdValues.resize(4, 0);
+        for(hsize_t c=0; c<chunkDims[1]; ++c)
+          cdValues.push_back(mode(c));
+        for(hsize_t c=chunkDims[1]; c<dims[1]; ++c)
+          if(mode(c)!=mode(c%chunkDims[1]))
+            throw Exception(getPath(), "The prediction modes must repeat with the number of columns per chunk.");
+      }
+      H5Pset_filter(propID, predictFilterID, 0, cdValues.size(), cdValues.data());
+    }
+    if(options.compression>0) H5Pset_deflate(propID, options.compression);
     ScopedHID apl(H5Pcreate(H5P_DATASET_ACCESS), &H5Pclose);
-    H5Pset_chunk_cache(apl, 521, sizeof(T)*dims[1]*chunkSize, 0.75);
+    H5Pset_chunk_cache(apl, 521, chunkRowCacheSize(), 0.75);
     id.reset(H5Dcreate2(parent->getID(), name.c_str(), memDataTypeID,
                        fileDataSpaceID, H5P_DEFAULT, propID, apl), &H5Dclose);
+    if(keepBits>=0)
+      createChildAttribute<SimpleAttribute<double> >("Lossy Relative Error")()->write(options.relativeError);
+    if(quantizationStep>0)
+      createChildAttribute<SimpleAttribute<double> >("Lossy Absolute Error")()->write(options.absoluteError);
 
     hsize_t memDims[]={1, dims[1]};
     memDataSpaceID.reset(H5Screate_simple(2, memDims, nullptr), &H5Sclose);
+    initParallelRead();
     msg(Debug)<<"HDF5:\n"
               <<"Created object with name = "<<name<<", id = "<<id<<" at parent with id = "<<parent->getID()<<"."<<endl;
   }
@@ -70,8 +108,22 @@ namespace H5 {
   template<class T>
   VectorSerie<T>::~VectorSerie() = default;
 
+  template<class T>
+  size_t VectorSerie<T>::chunkRowCacheSize() {
+    // all chunks of chunkDims[0] rows (in column layout a row is split over several chunks)
+    size_t chunksPerRow=(dims[1]+chunkDims[1]-1)/chunkDims[1];
+    return sizeof(T)*chunkDims[0]*chunkDims[1]*chunksPerRow;
+  }
+
   template<class T>
   void VectorSerie<T>::close() {
+    flushDirectChunks();
+    if(pyramid)
+      pyramid->close();
+    if(timeIndex)
+      timeIndex->close();
+    if(zoneMap)
+      zoneMap->close();
     Dataset::close();
     memDataSpaceID.reset();
     id.reset();
@@ -89,30 +141,455 @@ namespace H5 {
     if(maxDims[0]!=H5S_UNLIMITED)
       throw Exception(getPath(), "A VectorSerie dataset must have unlimited dimension in the first dimension.");
     ScopedHID cpl(H5Dget_create_plist(id), &H5Pclose);
-    H5Pget_chunk(cpl, 2, maxDims);
+    H5Pget_chunk(cpl, 2, chunkDims);
     ScopedHID apl(H5Dget_access_plist(id), &H5Pclose);
     id.reset();
     // reopen the dataset with chunk cache == chunk size
-    H5Pset_chunk_cache(apl, 521, sizeof(T)*dims[1]*maxDims[0], 0.75);
+    H5Pset_chunk_cache(apl, 521, chunkRowCacheSize(), 0.75);
     id.reset(H5Dopen(parent->getID(), name.c_str(), apl), &H5Dclose);
 
     // create mem space
     hsize_t memDims[]={1, dims[1]};
     memDataSpaceID.reset(H5Screate_simple(2, memDims, nullptr), &H5Sclose);
+    initParallelRead();
+    // the pyramid of a writer is kept (with its incomplete blocks) when the file is reopened
+    if(pyramid)
+      pyramid->reopen(parent->getID());
+    else if(memDataTypeID!=returnVarLenStrDatatypeID())
+      pyramid=Pyramid::open(parent->getID(), name);
+    if(timeIndex)
+      timeIndex->reopen(parent->getID());
+    else if(memDataTypeID!=returnVarLenStrDatatypeID())
+      timeIndex=TimeIndex::open(parent->getID(), name, chunkDims[0]);
+    if(zoneMap)
+      zoneMap->reopen(parent->getID());
+    else if(memDataTypeID!=returnVarLenStrDatatypeID())
+      zoneMap=ZoneMap::open(parent->getID(), name, chunkDims[0]);
     msg(Debug)<<"HDF5:\n"
               <<"Opened object with name = "<<name<<", id = "<<id<<" at parent with id = "<<parent->getID()<<"."<<endl;
     Dataset::open();
   }
 
+  template<class T>
+  void VectorSerie<T>::flush() {
+    flushDirectChunks();
+    Dataset::flush();
+    if(pyramid)
+      pyramid->flush();
+    if(timeIndex)
+      timeIndex->flush();
+    if(zoneMap)
+      zoneMap->flush();
+  }
+
+  template<class T>
+  void VectorSerie<T>::refresh() {
+    Dataset::refresh();
+    if(pyramid)
+      pyramid->refresh();
+    if(timeIndex)
+      timeIndex->refresh();
+    if(zoneMap)
+      zoneMap->refresh();
+  }
+
   template<class T>
   void VectorSerie<T>::setDescription(const string& description) {
     SimpleAttribute<string> *desc=createChildAttribute<SimpleAttribute<string> >("Description")();
     desc->write(description);
   }
 
+  template<class T>
+  void VectorSerie<T>::enableDirectChunkWrite() {
+    if(memDataTypeID==returnVarLenStrDatatypeID())
+      throw Exception(getPath(), "Direct chunk write is not supported for string datasets.");
+    ScopedHID ftype(H5Dget_type(id), &H5Tclose);
+    if(H5Tequal(ftype, memDataTypeID)<=0)
+      throw Exception(getPath(), "Direct chunk write requires a file datatype equal to the native datatype.");
+    if(chunkDims[1]!=dims[1])
+      throw Exception(getPath(), "Direct chunk write is not supported for datasets in column layout.");
+    ScopedHID cpl(H5Dget_create_plist(id), &H5Pclose);
+    auto codec=make_shared<ChunkCodec>(cpl);
+    if(!codec->isSupported())
+      throw Exception(getPath(), "Direct chunk write is not supported for the filters of this dataset.");
+    directChunkCodec=codec;
+    directChunkPool=ThreadPool::global();
+  }
+
+  template<class T>
+  void VectorSerie<T>::writeDirectChunks(bool all) {
+    // write the encoded chunks in order; wait for the oldest one if too many are pending
+    while(!directChunkPending.empty() &&
+          (all || directChunkPending.size()>static_cast<size_t>(directChunkPool->size()) ||
+           directChunkPending.front().second.wait_for(chrono::seconds(0))==future_status::ready)) {
+      hsize_t offset[]={directChunkPending.front().first, 0};
+      vector<char> data=directChunkPending.front().second.get();
+      directChunkPending.pop_front();
+      hsize_t extent[]={offset[0]+chunkDims[0], dims[1]};
+      H5Dset_extent(id, extent);
+      H5Dwrite_chunk(id, H5P_DEFAULT, 0, offset, data.size(), data.data());
+    }
+  }
+
+  template<class T>
+  void VectorSerie<T>::flushDirectChunks() {
+    if(!directChunkCodec)
+      return;
+    writeDirectChunks(true);
+    if(directChunkBuffer.empty())
+      return;
+    // write the rows of the incomplete chunk the normal way (following rows are also written the normal way until
+    // the next chunk starts)
+    H5Dset_extent(id, dims);
+    hsize_t count[]={directChunkBuffer.size()/dims[1], dims[1]};
+    hsize_t start[]={dims[0]-count[0], 0};
+    ScopedHID fileDataSpaceID(H5Dget_space(id), &H5Sclose);
+    H5Sselect_hyperslab(fileDataSpaceID, H5S_SELECT_SET, start, nullptr, count, nullptr);
+    ScopedHID memDataSpace(H5Screate_simple(2, count, nullptr), &H5Sclose);
+    H5Dwrite(id, memDataTypeID, memDataSpace, fileDataSpaceID, H5P_DEFAULT, directChunkBuffer.data());
+    directChunkBuffer.clear();
+  }
+
+  template<class T>
+  void VectorSerie<T>::initParallelRead() {
+    parallelReadCodec.reset();
+#if H5_VERSION_GE(1, 10, 2)
+    // only compressed datasets without datatype conversion can be read in parallel
+    if(memDataTypeID==returnVarLenStrDatatypeID())
+      return;
+    ScopedHID ftype(H5Dget_type(id), &H5Tclose);
+    if(H5Tequal(ftype, memDataTypeID)<=0)
+      return;
+    ScopedHID cpl(H5Dget_create_plist(id), &H5Pclose);
+    auto codec=make_shared<ChunkCodec>(cpl);
+    if(codec->isSupported() && !codec->isEmpty())
+      parallelReadCodec=codec;
+#endif
+  }
+
+  // Read the rows [startRow, startRow+count[ (all columns if column<0, else only column) to data.
+  // The raw chunks are read by this thread (HDF5 is not thread-safe) while the decompression and the copy to data
+  // is done by the worker threads. Returns false (and reads nothing) if the parallel read is not possible or not worth it.
+  template<class T>
+  bool VectorSerie<T>::readChunksParallel(hsize_t startRow, hsize_t count, int column, T data[]) {
+#if H5_VERSION_GE(1, 10, 2)
+    if(!parallelReadCodec || File::getNumberOfWorkerThreads()<2 || count==0)
+      return false;
+    // in column layout only a single column can be read in parallel
+    if(column<0 && chunkDims[1]!=dims[1])
+      return false;
+    hsize_t firstChunk=startRow/chunkDims[0];
+    hsize_t lastChunk=(startRow+count-1)/chunkDims[0];
+    if(firstChunk==lastChunk)
+      return false;
+
+    auto pool=ThreadPool::global();
+    auto codec=parallelReadCodec;
+    size_t cols=chunkDims[1]; // the number of columns in a chunk
+    size_t chunkRows=chunkDims[0];
+    size_t rawSize=chunkRows*cols*sizeof(T);
+    // the first column of the chunks to read and the column within these chunks
+    hsize_t chunkColumn=column<0 ? 0 : column/cols*cols;
+    int columnInChunk=column<0 ? -1 : column-chunkColumn;
+    // copy the rows of the chunk starting at chunkStart (raw chunk data) which are requested to data
+    auto scatter=[startRow, count, columnInChunk, data, cols, chunkRows](hsize_t chunkStart, const T *chunk) {
+      hsize_t begin=max(startRow, chunkStart);
+      hsize_t end=min(startRow+count, chunkStart+chunkRows);
+      if(columnInChunk<0)
+        copy(chunk+(begin-chunkStart)*cols, chunk+(end-chunkStart)*cols, data+(begin-startRow)*cols);
+      else
+        for(hsize_t r=begin; r<end; ++r)
+          data[r-startRow]=chunk[(r-chunkStart)*cols+columnInChunk];
+    };
+
+    // limit the number of chunks in memory to twice the number of threads
+    deque<future<void>> pending;
+    vector<future<void>> done; // finished tasks, their exceptions are thrown at the end
+    try {
+      for(hsize_t c=firstChunk; c<=lastChunk; ++c) {
+        hsize_t offset[]={c*chunkRows, chunkColumn};
+        hsize_t nbytes=0;
+        if(H5Dget_chunk_storage_size(id, offset, &nbytes)<0 || nbytes==0) {
+          // chunk not allocated: use the fill value
+          vector<T> fill(chunkRows*cols, T());
+          scatter(offset[0], fill.data());
+          continue;
+        }
+        vector<char> raw(nbytes);
+        uint32_t filterMask=0;
+        if(H5Dread_chunk(id, H5P_DEFAULT, offset, &filterMask, raw.data())<0)
+          throw Exception(getPath(), "Reading chunk "+to_string(c)+" failed.");
+        pending.emplace_back(pool->submit([codec, raw=std::move(raw), filterMask, rawSize, scatter, chunkStart=offset[0]]() mutable {
+          vector<char> chunk=codec->decode(std::move(raw), filterMask, rawSize);
+          scatter(chunkStart, reinterpret_cast<const T*>(chunk.data()));
+        }));
+        while(pending.size()>2*static_cast<size_t>(pool->size())) {
+          pending.front().wait();
+          done.emplace_back(std::move(pending.front()));
+          pending.pop_front();
+        }
+      }
+    }
+    catch(...) {
+      // the tasks write to data: wait for all of them before the caller gets the exception
+      for(auto &p : pending)
+        p.wait();
+      throw;
+    }
+    // wait for all tasks (before throwing a exception of any of them, since they write to data)
+    for(auto &p : pending)
+      p.wait();
+    for(auto &p : done)
+      p.get();
+    for(auto &p : pending)
+      p.get();
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  template<class T>
+  void VectorSerie<T>::enablePyramid(int factor, int levels) {
+    if constexpr(is_same_v<T, string>)
+      throw Exception(getPath(), "A pyramid is not supported for string datasets.");
+    else {
+      if(pyramid)
+        throw Exception(getPath(), "The dataset has already a pyramid.");
+      ScopedHID cpl(H5Dget_create_plist(id), &H5Pclose);
+      try {
+        pyramid=make_shared<Pyramid>(parent->getID(), name, dims[1], factor, levels, chunkDims[0], getDeflateLevel(cpl));
+      }
+      catch(const runtime_error &ex) {
+        throw Exception(getPath(), ex.what());
+      }
+      // add the existing rows
+      int rows=getRows();
+      vector<T> data(chunkDims[0]*dims[1]);
+      vector<double> row(dims[1]);
+      for(int start=0; start<rows; start+=chunkDims[0]) {
+        int count=min<int>(chunkDims[0], rows-start);
+        getRowRange(start, count, count*dims[1], data.data());
+        for(int r=0; r<count; ++r) {
+          copy(&data[r*dims[1]], &data[(r+1)*dims[1]], row.begin());
+          pyramid->append(row.data());
+        }
+      }
+    }
+  }
+
+  template<class T>
+  void VectorSerie<T>::initLossy(double relativeError, double absoluteError) {
+    if(relativeError<0 || absoluteError<0 || std::isnan(relativeError) || std::isnan(absoluteError))
+      throw Exception(getPath(), "The error bounds of the lossy storage must be non-negative.");
+    if(relativeError==0 && absoluteError==0)
+      return;
+    if constexpr(!is_same_v<T, double> && !is_same_v<T, float>)
+      throw Exception(getPath(), "Lossy storage is only supported for float and double datasets.");
+    else {
+      if(relativeError>0 && absoluteError>0)
+        throw Exception(getPath(), "A relative and a absolute error bound cannot be combined.");
+      if(relativeError>0)
+        keepBits=getKeepBits(relativeError, numeric_limits<T>::digits-1);
+      else
+        quantizationStep=getQuantizationStep(absoluteError);
+    }
+  }
+
+  template<class T>
+  const T* VectorSerie<T>::roundRow(const T data[], size_t size) {
+    if constexpr(is_same_v<T, double> || is_same_v<T, float>) {
+      if(keepBits<0 && quantizationStep==0)
+        return data;
+      roundedRow.assign(data, data+size);
+      if(keepBits>=0)
+        roundMantissa(roundedRow.data(), size, keepBits);
+      else
+        quantize(roundedRow.data(), size, quantizationStep);
+      return roundedRow.data();
+    }
+    else
+      return data;
+  }
+
+  template<class T>
+  vector<double> VectorSerie<T>::readColumnAsDouble(int column, hsize_t begin, hsize_t end) {
+    if constexpr(is_same_v<T, string>)
+      throw Exception(getPath(), "Internal error: a string column cannot be converted to double.");
+    else {
+      vector<T> data(end-begin);
+      if(data.empty())
+        return vector<double>();
+      hsize_t start[]={begin, static_cast<hsize_t>(column)};
+      hsize_t count[]={end-begin, 1};
+      ScopedHID fileDataSpaceID(H5Dget_space(id), &H5Sclose);
+      H5Sselect_hyperslab(fileDataSpaceID, H5S_SELECT_SET, start, nullptr, count, nullptr);
+      ScopedHID memDataSpace(H5Screate_simple(2, count, nullptr), &H5Sclose);
+      H5Dread(id, memDataTypeID, memDataSpace, fileDataSpaceID, H5P_DEFAULT, data.data());
+      return vector<double>(data.begin(), data.end());
+    }
+  }
+
+  template<class T>
+  Envelope VectorSerie<T>::getEnvelope(int column, int startRow, int endRow, int points) {
+    if constexpr(is_same_v<T, string>)
+      throw Exception(getPath(), "A envelope is not supported for string datasets.");
+    else {
+      flushDirectChunks();
+      int rows=getRows();
+      if(column<0 || static_cast<hsize_t>(column)>=dims[1])
+        throw Exception(getPath(), "Requested column "+to_string(column)+" is out of range.");
+      if(startRow<0 || startRow>endRow || endRow>rows)
+        throw Exception(getPath(), "Requested rows ["+to_string(startRow)+".."+to_string(endRow)+
+                                   "[ are out of range [0.."+to_string(rows)+"[.");
+      return Pyramid::getEnvelope(pyramid.get(), column, startRow, endRow, points, [this, column](hsize_t begin, hsize_t end) {
+        return readColumnAsDouble(column, begin, end);
+      });
+    }
+  }
+
+  template<class T>
+  int VectorSerie<T>::getPyramidFactor() {
+    return pyramid ? pyramid->getFactor() : 0;
+  }
+
+  template<class T>
+  int VectorSerie<T>::getPyramidLevels() {
+    return pyramid ? pyramid->getLevels() : 0;
+  }
+
+  template<class T>
+  int VectorSerie<T>::getTimeIndexColumn() {
+    return timeIndex ? timeIndex->getColumn() : -1;
+  }
+
+  template<class T>
+  void VectorSerie<T>::enableTimeIndex(int column) {
+    if constexpr(is_same_v<T, string>)
+      throw Exception(getPath(), "A time index is not supported for string datasets.");
+    else {
+      if(timeIndex)
+        throw Exception(getPath(), "The dataset has already a time index.");
+      if(column<0 || static_cast<hsize_t>(column)>=dims[1])
+        throw Exception(getPath(), "Requested column "+to_string(column)+" is out of range.");
+      timeIndex=make_shared<TimeIndex>(parent->getID(), name, column, chunkDims[0]);
+      // add the existing rows
+      int rows=getRows();
+      vector<T> data(rows);
+      getColumn(column, rows, data.data());
+      for(int r=0; r<rows; ++r)
+        timeIndex->append(r, data[r]);
+    }
+  }
+
+  template<class T>
+  pair<int, int> VectorSerie<T>::findRowRange(double tBegin, double tEnd) {
+    if constexpr(is_same_v<T, string>)
+      throw Exception(getPath(), "A time range is not supported for string datasets.");
+    else {
+      if(std::isnan(tBegin) || std::isnan(tEnd))
+        throw Exception(getPath(), "The bounds of a time range must not be NaN.");
+      flushDirectChunks();
+      hsize_t rows=getRows();
+      int column=timeIndex ? timeIndex->getColumn() : 0;
+      auto readColumn=[this, column](hsize_t begin, hsize_t end) {
+        return readColumnAsDouble(column, begin, end);
+      };
+      hsize_t first=TimeIndex::partitionPoint(timeIndex.get(), rows, chunkDims[0], [tBegin](double t) { return t<tBegin; }, readColumn);
+      hsize_t end=TimeIndex::partitionPoint(timeIndex.get(), rows, chunkDims[0], [tEnd](double t) { return t<=tEnd; }, readColumn);
+      return make_pair(first, max(first, end));
+    }
+  }
+
+  template<class T>
+  void VectorSerie<T>::enableZoneMap() {
+    if constexpr(is_same_v<T, string>)
+      throw Exception(getPath(), "A zone map is not supported for string datasets.");
+    else {
+      if(zoneMap)
+        throw Exception(getPath(), "The dataset has already a zone map.");
+      ScopedHID cpl(H5Dget_create_plist(id), &H5Pclose);
+      zoneMap=make_shared<ZoneMap>(parent->getID(), name, dims[1], chunkDims[0], getDeflateLevel(cpl));
+      // add the existing rows
+      int rows=getRows();
+      vector<T> data(chunkDims[0]*dims[1]);
+      vector<double> row(dims[1]);
+      for(int start=0; start<rows; start+=chunkDims[0]) {
+        int count=min<int>(chunkDims[0], rows-start);
+        getRowRange(start, count, count*dims[1], data.data());
+        for(int r=0; r<count; ++r) {
+          copy(&data[r*dims[1]], &data[(r+1)*dims[1]], row.begin());
+          zoneMap->append(start+r, row.data());
+        }
+      }
+    }
+  }
+
+  template<class T>
+  vector<int> VectorSerie<T>::findRowsWithZoneMap(int column, const function<bool(double, double, double)> &mayMatch,
+                                                  const function<bool(double)> &pred, size_t *chunksRead) {
+    if constexpr(is_same_v<T, string>)
+      throw Exception(getPath(), "Searching rows is not supported for string datasets.");
+    else {
+      flushDirectChunks();
+      hsize_t rows=getRows();
+      if(column<0 || static_cast<hsize_t>(column)>=dims[1])
+        throw Exception(getPath(), "Requested column "+to_string(column)+" is out of range.");
+      vector<hsize_t> ret=ZoneMap::findRows(zoneMap.get(), column, rows, chunkDims[0], mayMatch, pred,
+        [this, column](hsize_t begin, hsize_t end) { return readColumnAsDouble(column, begin, end); }, chunksRead);
+      return vector<int>(ret.begin(), ret.end());
+    }
+  }
+
+  template<class T>
+  vector<int> VectorSerie<T>::findRows(int column, double lower, double upper, size_t *chunksRead) {
+    return findRowsWithZoneMap(column, [lower, upper](double min, double max, double nanCount) {
+      return max>=lower && min<=upper;
+    }, [lower, upper](double v) {
+      return lower<=v && v<=upper;
+    }, chunksRead);
+  }
+
+  template<class T>
+  vector<int> VectorSerie<T>::findNaNRows(int column, size_t *chunksRead) {
+    return findRowsWithZoneMap(column, [](double min, double max, double nanCount) {
+      return nanCount>0;
+    }, [](double v) {
+      return isnan(v);
+    }, chunksRead);
+  }
+
   template<class T>
   void VectorSerie<T>::append(const T data[], size_t size) {
     if(size!=dims[1]) throw Exception(getPath(), "dataset dimension does not match");
+    // the index, the pyramid and the zone map are built from the values actually stored
+    data=roundRow(data, size);
+    if(timeIndex)
+      timeIndex->append(dims[0], data[timeIndex->getColumn()]);
+    if(pyramid || zoneMap) {
+      rowAsDouble.assign(data, data+size);
+      if(pyramid)
+        pyramid->append(rowAsDouble.data());
+      if(zoneMap)
+        zoneMap->append(dims[0], rowAsDouble.data());
+    }
+    if(directChunkCodec && (dims[0]%chunkDims[0]==0 || !directChunkBuffer.empty())) {
+      // buffer the row; encode the chunk in a worker thread if it is complete
+      directChunkBuffer.insert(directChunkBuffer.end(), data, data+size);
+      dims[0]++;
+      if(directChunkBuffer.size()==chunkDims[0]*dims[1]) {
+        auto codec=directChunkCodec;
+        directChunkPending.emplace_back(dims[0]-chunkDims[0], directChunkPool->submit(
+          [codec, buffer=std::move(directChunkBuffer)]() {
+            return codec->encode(reinterpret_cast<const char*>(buffer.data()), buffer.size()*sizeof(T));
+          }
+        ));
+        directChunkBuffer.clear();
+        directChunkBuffer.reserve(chunkDims[0]*dims[1]);
+      }
+      writeDirectChunks(false);
+      return;
+    }
     dims[0]++;
     H5Dset_extent(id, dims);
 
@@ -126,6 +603,7 @@ namespace H5 {
 
   template<class T>
   void VectorSerie<T>::getRow(const int row, size_t size, T data[]) {
+    flushDirectChunks();
     if(size!=dims[1])
       throw Exception(getPath(), "Size of data does not match");
     int rows=getRows();
@@ -145,11 +623,97 @@ namespace H5 {
     H5Dread(id, memDataTypeID, memDataSpaceID, fileDataSpaceID, H5P_DEFAULT, &data[0]);
  }
 
+  template<class T>
+  void VectorSerie<T>::getRowRange(int startRow, int count, size_t size, T data[]) {
+    flushDirectChunks();
+    if(size!=static_cast<size_t>(count)*dims[1])
+      throw Exception(getPath(), "Size of data does not match");
+    int rows=getRows();
+    if(startRow<0 || count<0 || startRow+count>rows)
+      throw Exception(getPath(), "Requested rows ["+to_string(startRow)+".."+to_string(startRow+count)+
+                                 "[ are out of range [0.."+to_string(rows)+"[.");
+    if(count==0)
+      return;
+    if(readChunksParallel(startRow, count, -1, data))
+      return;
+
+    hsize_t start[]={(hsize_t)startRow, 0};
+    hsize_t cnt[]={(hsize_t)count, dims[1]};
+    ScopedHID fileDataSpaceID(H5Dget_space(id), &H5Sclose);
+    H5Sselect_hyperslab(fileDataSpaceID, H5S_SELECT_SET, start, nullptr, cnt, nullptr);
+    ScopedHID memDataSpace(H5Screate_simple(2, cnt, nullptr), &H5Sclose);
+    H5Dread(id, memDataTypeID, memDataSpace, fileDataSpaceID, H5P_DEFAULT, data);
+  }
+
+  template<class T>
+  void VectorSerie<T>::getRowRange(int startRow, int count, const vector<int> &columns, size_t size, T data[], int stride) {
+    flushDirectChunks();
+    if(size!=static_cast<size_t>(count)*columns.size())
+      throw Exception(getPath(), "Size of data does not match");
+    if(stride<1)
+      throw Exception(getPath(), "The stride must be positive.");
+    int rows=getRows();
+    int endRow=count>0 ? startRow+(count-1)*stride+1 : startRow;
+    if(startRow<0 || count<0 || endRow>rows)
+      throw Exception(getPath(), "Requested rows ["+to_string(startRow)+".."+to_string(endRow)+
+                                 "[ are out of range [0.."+to_string(rows)+"[.");
+    for(int c : columns)
+      if(c<0 || static_cast<hsize_t>(c)>=dims[1])
+        throw Exception(getPath(), "Requested column "+to_string(c)+" is out of range.");
+    if(count==0 || columns.empty())
+      return;
+
+    // select each column only once, in file order, and contiguous columns as one block
+    vector<int> fileColumns(columns);
+    sort(fileColumns.begin(), fileColumns.end());
+    fileColumns.erase(unique(fileColumns.begin(), fileColumns.end()), fileColumns.end());
+    ScopedHID fileDataSpaceID(H5Dget_space(id), &H5Sclose);
+    for(size_t i=0, j; i<fileColumns.size(); i=j) {
+      for(j=i+1; j<fileColumns.size() && fileColumns[j]==fileColumns[j-1]+1; ++j);
+      hsize_t start[]={(hsize_t)startRow, (hsize_t)fileColumns[i]};
+      hsize_t str[]={(hsize_t)stride, 1};
+      hsize_t cnt[]={(hsize_t)count, 1};
+      hsize_t blk[]={1, j-i};
+      H5Sselect_hyperslab(fileDataSpaceID, i==0 ? H5S_SELECT_SET : H5S_SELECT_OR, start, str, cnt, blk);
+    }
+    hsize_t memDims[]={(hsize_t)count, fileColumns.size()};
+    ScopedHID memDataSpace(H5Screate_simple(2, memDims, nullptr), &H5Sclose);
+
+    // map the read columns to the requested order
+    auto scatter=[&columns, &fileColumns, count, data](auto &buffer) {
+      vector<size_t> pos(columns.size());
+      for(size_t i=0; i<columns.size(); ++i)
+        pos[i]=lower_bound(fileColumns.begin(), fileColumns.end(), columns[i])-fileColumns.begin();
+      for(int r=0; r<count; ++r)
+        for(size_t i=0; i<columns.size(); ++i)
+          data[r*columns.size()+i]=buffer[r*fileColumns.size()+pos[i]];
+    };
+    if constexpr(is_same_v<T, string>) {
+      VecStr buffer(count*fileColumns.size());
+      H5Dread(id, memDataTypeID, memDataSpace, fileDataSpaceID, H5P_DEFAULT, &buffer[0]);
+      scatter(buffer);
+    }
+    else {
+      if(fileColumns==columns) {
+        H5Dread(id, memDataTypeID, memDataSpace, fileDataSpaceID, H5P_DEFAULT, data);
+        return;
+      }
+      vector<T> buffer(count*fileColumns.size());
+      H5Dread(id, memDataTypeID, memDataSpace, fileDataSpaceID, H5P_DEFAULT, buffer.data());
+      scatter(buffer);
+    }
+  }
+
   template<class T>
   void VectorSerie<T>::getColumn(const int column, size_t size, T data[]) {
+    flushDirectChunks();
     hsize_t rows=getRows();
     if(size!=rows)
       throw Exception(getPath(), "dataset dimension does not match");
+    if(column<0 || static_cast<hsize_t>(column)>=dims[1])
+      throw Exception(getPath(), "Requested column "+to_string(column)+" is out of range.");
+    if(readChunksParallel(0, rows, column, data))
+      return;
     hsize_t start[]={0, (hsize_t)column};
     hsize_t count[]={rows, 1};
     ScopedHID fileDataSpaceID(H5Dget_space(id), &H5Sclose);
@@ -227,6 +791,29 @@ namespace H5 {
       data[i]=dummy[i];
  }
   
+  template<>
+  void VectorSerie<string>::getRowRange(int startRow, int count, size_t size, string data[]) {
+    if(size!=static_cast<size_t>(count)*dims[1])
+      throw Exception(getPath(), "Size of data does not match");
+    int rows=getRows();
+    if(startRow<0 || count<0 || startRow+count>rows)
+      throw Exception(getPath(), "Requested rows ["+to_string(startRow)+".."+to_string(startRow+count)+
+                                 "[ are out of range [0.."+to_string(rows)+"[.");
+    if(count==0)
+      return;
+
+    hsize_t start[]={(hsize_t)startRow, 0};
+    hsize_t cnt[]={(hsize_t)count, dims[1]};
+    ScopedHID fileDataSpaceID(H5Dget_space(id), &H5Sclose);
+    H5Sselect_hyperslab(fileDataSpaceID, H5S_SELECT_SET, start, nullptr, cnt, nullptr);
+    ScopedHID memDataSpace(H5Screate_simple(2, cnt, nullptr), &H5Sclose);
+
+    VecStr dummy(size);
+    H5Dread(id, memDataTypeID, memDataSpace, fileDataSpaceID, H5P_DEFAULT, &dummy[0]);
+    for(size_t i=0; i<size; i++)
+      data[i]=dummy[i];
+  }
+
   template<>
   void VectorSerie<string>::getColumn(const int column, size_t size, string data[]) {
     hsize_t rows=getRows();
@@ -24,10 +24,68 @@
 
 #include <hdf5serie/interface.h>
 #include <hdf5serie/file.h>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
 #include <vector>
 
 namespace H5 {
 
+  class ChunkCodec;
+  class ThreadPool;
+  class Pyramid;
+  class TimeIndex;
+  class ZoneMap;
+
+  //! The prediction of the values of a column by the predictive filter, see VectorSerieOptions::predictModes.
+  enum PredictMode {
+    predictNone=0, //!< no prediction
+    predictDelta=1, //!< difference to the previous row (good for monotone values like time)
+    predictXOR=2 //!< XOR with the previous row (good for smooth floating point signals)
+  };
+
+  //! Creation options of a VectorSerie.
+  struct VectorSerieOptions {
+    VectorSerieOptions() = default;
+    VectorSerieOptions(int compression_, int chunkSize_, int columnsPerChunk_=0) :
+      compression(compression_), chunkSize(chunkSize_), columnsPerChunk(columnsPerChunk_) {}
+    //! The deflate compression level (0 = no compression).
+    int compression { File::getDefaultCompression() };
+    //! The number of rows per chunk.
+    int chunkSize { File::getDefaultChunkSize() };
+    //! The number of columns per chunk (0 = all columns), see VectorSerie.
+    int columnsPerChunk { 0 };
+    //! Apply the predictive filter of this library before the compression: in each chunk, the values of each column
+    //! are replaced by a prediction residual with respect to the previous row (see predictModes).
+    //! The results are stored byte plane by byte plane. This results in much better compression
+    //! of smooth signals. Files using this filter can only be read by this library (the filter is stored in the file).
+    //! Ignored for std::string.
+    bool predictiveFilter { false };
+    //! The prediction mode of each column used by the predictive filter. If empty, the first column (usually the time)
+    //! uses predictDelta and all other columns predictXOR. Columns behind the last given mode use predictXOR.
+    //! The filter knows only the columns of a chunk: with columnsPerChunk>0 the modes must repeat with columnsPerChunk.
+    std::vector<PredictMode> predictModes;
+    //! Lossy storage (only for float and double): if > 0 the mantissa of each appended value is rounded to the fewest bits
+    //! keeping the relative error <= relativeError (e.g. 1e-6 for about 6 significant digits).
+    //! The trailing zero bits are then removed by the compression. The value is stored in the attribute
+    //! \p Lossy Relative Error of the dataset. The data can be read by any HDF5 reader.
+    double relativeError { 0 };
+    //! Lossy storage (only for float and double): if > 0 each appended value is rounded to a multiple of the largest
+    //! power of two keeping the absolute error <= absoluteError. The value is stored in the attribute
+    //! \p Lossy Absolute Error of the dataset. Cannot be combined with relativeError.
+    double absoluteError { 0 };
+  };
+
+  //! The envelope of a column of a VectorSerie, see VectorSerie::getEnvelope.
+  struct Envelope {
+    std::vector<hsize_t> firstRow; //!< the first row of each bin
+    std::vector<hsize_t> rows; //!< the number of rows of each bin
+    std::vector<double> min; //!< the minimal value of each bin
+    std::vector<double> max; //!< the maximal value of each bin
+    std::vector<double> mean; //!< the mean value of each bin
+  };
+
 
    
   /** \brief Serie of vectors.
@@ -52,6 +110,12 @@ namespace H5 {
    *
    * The data is stored as a 2D array in the HDF5 file. Each row is onw data vector.
    *
+   * By default each chunk of the dataset holds chunkSize complete rows (row layout): appending and reading rows is cheap
+   * but reading a single column must decompress all columns. If columnsPerChunk (a creation parameter) is greater than 0
+   * (and less than the number of columns), each chunk holds only columnsPerChunk columns of chunkSize rows (column layout):
+   * reading a single column decompresses only the chunks of this column, but appending and reading rows touches more chunks.
+   * The API is the same for both layouts. Direct chunk write (enableDirectChunkWrite) needs the row layout.
+   *
    * A note when using a vector-matrix-library:
    * It is likly that the data is calculated by a vector-matrix-library. If so,
    * and the vector object (of type T) of the library (e.g. fmatvec) has a size() member function, returning
@@ -66,13 +130,50 @@ namespace H5 {
       hid_t memDataTypeID;
       ScopedHID memDataSpaceID;
       hsize_t dims[2];
+      hsize_t chunkDims[2];
+      size_t chunkRowCacheSize();
+
+      // direct chunk write, see enableDirectChunkWrite
+      std::shared_ptr<ChunkCodec> directChunkCodec;
+      std::shared_ptr<ThreadPool> directChunkPool;
+      std::vector<T> directChunkBuffer; // the rows of the current chunk not written yet
+      std::deque<std::pair<hsize_t, std::future<std::vector<char>>>> directChunkPending; // start row and encoded data
+      void writeDirectChunks(bool all);
+      void flushDirectChunks();
+
+      // parallel read, see readChunksParallel
+      std::shared_ptr<ChunkCodec> parallelReadCodec; // nullptr if the dataset cannot be read in parallel
+      void initParallelRead();
+      bool readChunksParallel(hsize_t startRow, hsize_t count, int column, T data[]);
+
+      std::shared_ptr<Pyramid> pyramid; // see enablePyramid
+      std::vector<double> rowAsDouble; // the appended row converted to double (for the pyramid and the zone map)
+
+      std::shared_ptr<TimeIndex> timeIndex; // see enableTimeIndex
+
+      std::shared_ptr<ZoneMap> zoneMap; // see enableZoneMap
+      std::vector<int> findRowsWithZoneMap(int column, const std::function<bool(double, double, double)> &mayMatch,
+                                           const std::function<bool(double)> &pred, size_t *chunksRead);
+
+      // lossy storage, see VectorSerieOptions::relativeError and VectorSerieOptions::absoluteError
+      int keepBits { -1 }; // -1 = no mantissa rounding
+      double quantizationStep { 0 }; // 0 = no quantization
+      std::vector<T> roundedRow;
+      void initLossy(double relativeError, double absoluteError);
+      const T* roundRow(const T data[], size_t size);
+
+      // read the rows [begin, end[ of column and convert them to double (not for std::string)
+      std::vector<double> readColumnAsDouble(int column, hsize_t begin, hsize_t end);
     protected:
       VectorSerie(int dummy, GroupBase *parent_, const std::string &name_);
       VectorSerie(GroupBase *parent_, const std::string &name_, int cols,
-        int compression=File::getDefaultCompression(), int chunkSize=File::getDefaultChunkSize());
+        int compression=File::getDefaultCompression(), int chunkSize=File::getDefaultChunkSize(), int columnsPerChunk=0);
+      VectorSerie(GroupBase *parent_, const std::string &name_, int cols, const VectorSerieOptions &options);
       ~VectorSerie() override;
       void close() override;
       void open() override;
+      void flush() override;
+      void refresh() override;
 
     public:
       /** \brief Sets a description for the dataset
@@ -81,6 +182,92 @@ namespace H5 {
        */
       void setDescription(const std::string& description);
 
+      /** \brief Write complete chunks directly
+       *
+       * Appended rows are buffered until a chunk is complete. Complete chunks are compressed by the worker threads
+       * of this library (see File::setNumberOfWorkerThreads) and written using H5Dwrite_chunk, bypassing the HDF5 filter pipeline.
+       * Buffered rows of a incomplete chunk are written using the HDF5 filter pipeline on flush and close
+       * and before any read of this dataset.
+       * Not supported for std::string and for filters other than deflate and shuffle.
+       */
+      void enableDirectChunkWrite();
+
+      /** \brief Maintain a min/max/mean pyramid of this dataset
+       *
+       * The pyramid is stored in hidden datasets next to this dataset and is updated on each append.
+       * Level l of the pyramid holds the min, max and mean of all columns for each block of factor^l rows.
+       * Rows already existing in the dataset are added to the pyramid by this call.
+       * Must be called before the file is reopened as SWMR. Not supported for std::string.
+       * See getEnvelope.
+       */
+      void enablePyramid(int factor=16, int levels=4);
+
+      //! Returns true if the dataset has a pyramid (see enablePyramid).
+      bool hasPyramid() { return pyramid!=nullptr; }
+
+      //! Returns the factor and the number of levels of the pyramid (see enablePyramid); 0 if no pyramid exists.
+      int getPyramidFactor();
+      int getPyramidLevels();
+
+      /** \brief Returns the envelope of column \a column for the rows [startRow, endRow[ using about \a points bins
+       *
+       * The bins are aligned to multiples of the bin size, which is at least (endRow-startRow)/points rows:
+       * all bins cover the same number of rows, except the first and the last one which may cover less rows.
+       * If the dataset has a pyramid, only the pyramid level matching the bin size and a few rows at the borders of
+       * the range are read (e.g. to plot a overview of a large dataset). Else the column is read completely.
+       * Not supported for std::string.
+       */
+      Envelope getEnvelope(int column, int startRow, int endRow, int points);
+
+      /** \brief Maintain a index of a time column of this dataset
+       *
+       * For each complete chunk the first and the last value of column \a column is stored in a hidden dataset next to
+       * this dataset. The index is updated on each append. The values of the column must be nondecreasing.
+       * Rows already existing in the dataset are added to the index by this call.
+       * Must be called before the file is reopened as SWMR. Not supported for std::string.
+       * See findRowRange.
+       */
+      void enableTimeIndex(int column=0);
+
+      //! Returns true if the dataset has a time index (see enableTimeIndex).
+      bool hasTimeIndex() { return timeIndex!=nullptr; }
+
+      //! Returns the column of the time index (see enableTimeIndex); -1 if no time index exists.
+      int getTimeIndexColumn();
+
+      /** \brief Returns the rows [first, second[ with a time value in [tBegin, tEnd]
+       *
+       * The time is the column of the time index or column 0 if the dataset has no time index (the values of the time
+       * column must be nondecreasing). With a time index only the index and the (at most two) chunks containing the
+       * borders of the range are read. Without a index a binary search on the time column is done.
+       * Use getRowRange to read the rows. Throws if tBegin or tEnd is NaN.
+       */
+      std::pair<int, int> findRowRange(double tBegin, double tEnd);
+
+      /** \brief Maintain per chunk statistics (zone map) of all columns of this dataset
+       *
+       * For each complete chunk the min value, the max value and the number of NaN values of each column are stored in a
+       * hidden dataset next to this dataset. The statistics are updated on each append.
+       * Rows already existing in the dataset are added to the statistics by this call.
+       * Must be called before the file is reopened as SWMR. Not supported for std::string.
+       * See findRows and findNaNRows.
+       */
+      void enableZoneMap();
+
+      //! Returns true if the dataset has a zone map (see enableZoneMap).
+      bool hasZoneMap() { return zoneMap!=nullptr; }
+
+      /** \brief Returns all rows with a value of column \a column in [lower, upper]
+       *
+       * Use -inf or inf as \a lower or \a upper for a one-sided condition. NaN values never match.
+       * If the dataset has a zone map, only chunks whose statistics do not rule out the condition are read.
+       * If \a chunksRead is not nullptr it is set to the number of chunks read.
+       */
+      std::vector<int> findRows(int column, double lower, double upper, size_t *chunksRead=nullptr);
+
+      //! Returns all rows with a NaN value in column \a column (see findRows).
+      std::vector<int> findNaNRows(int column, size_t *chunksRead=nullptr);
+
       /** \brief Append a data vector
        *
        * Appends the data vector \a data at the end of the dataset.
@@ -126,6 +313,25 @@ namespace H5 {
         return data;
       }
 
+      /** \brief Returns the data vectors of \a count rows starting at row \a startRow
+       *
+       * \a data points to an array of \a size elements of type T, which must be \a count times getColumns().
+       * The rows are stored one after the other in \a data.
+       * Compressed datasets spanning more than one chunk are decompressed in parallel by the worker threads of this
+       * library (see File::setNumberOfWorkerThreads). The same applies to getColumn.
+       */
+      void getRowRange(int startRow, int count, size_t size, T data[]);
+
+      /** \brief Returns the columns \a columns of \a count rows starting at row \a startRow
+       *
+       * Only the given columns (the first column is 0) of the rows startRow, startRow+stride, ... are read from the
+       * file using a hyperslab selection.
+       * \a columns can be in any order and can contain a column more than once.
+       * \a data points to an array of \a size elements of type T, which must be \a count times the size of \a columns.
+       * The rows are stored one after the other in \a data, each with the values of \a columns in the given order.
+       */
+      void getRowRange(int startRow, int count, const std::vector<int> &columns, size_t size, T data[], int stride=1);
+
       /** \brief Returns the data vector at column \a column
        *
        * The first column is 0. The last avaliable column ist getColumns()-1.
@@ -172,6 +378,9 @@ namespace H5 {
 
   template<class T>
   int VectorSerie<T>::getRows() {
+    // rows buffered for direct chunk write are not part of the dataset extent yet
+    if(!directChunkBuffer.empty() || !directChunkPending.empty())
+      return dims[0];
     ScopedHID fileSpaceID(H5Dget_space(id), &H5Sclose);
     H5Sget_simple_extent_dims(fileSpaceID, dims, nullptr);
     return dims[0];
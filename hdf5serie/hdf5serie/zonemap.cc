@@ -0,0 +1,129 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#include <config.h>
+#include "zonemap.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace H5 {
+
+ZoneMap::ZoneMap(int cols_, hsize_t chunkRows_) : cols(cols_), chunkRows(chunkRows_) {
+  stats.resize(3*cols);
+  resetStats();
+}
+
+ZoneMap::ZoneMap(hid_t parent, const string &name, int cols_, hsize_t chunkRows_, int compression) : ZoneMap(cols_, chunkRows_) {
+  ds.reset(new CompanionDataset(parent, CompanionDataset::getName(name, "zonemap"), 3*cols, chunkRows, compression, 3));
+}
+
+shared_ptr<ZoneMap> ZoneMap::open(hid_t parent, const string &name, hsize_t chunkRows_) {
+  string dsName=CompanionDataset::getName(name, "zonemap");
+  if(!CompanionDataset::exists(parent, dsName))
+    return nullptr;
+  auto ds=make_unique<CompanionDataset>(parent, dsName);
+  shared_ptr<ZoneMap> zoneMap(new ZoneMap(ds->getColumns()/3, chunkRows_));
+  zoneMap->ds=std::move(ds);
+  return zoneMap;
+}
+
+void ZoneMap::close() {
+  ds->close();
+}
+
+void ZoneMap::reopen(hid_t parent) {
+  ds->reopen(parent);
+}
+
+void ZoneMap::flush() {
+  ds->flush();
+}
+
+void ZoneMap::refresh() {
+  ds->refresh();
+}
+
+void ZoneMap::resetStats() {
+  for(int c=0; c<cols; ++c) {
+    stats[3*c+0]=numeric_limits<double>::infinity();
+    stats[3*c+1]=-numeric_limits<double>::infinity();
+    stats[3*c+2]=0;
+  }
+}
+
+void ZoneMap::append(hsize_t row, const double *data) {
+  for(int c=0; c<cols; ++c) {
+    if(isnan(data[c]))
+      stats[3*c+2]++;
+    else {
+      if(data[c]<stats[3*c+0]) stats[3*c+0]=data[c];
+      if(data[c]>stats[3*c+1]) stats[3*c+1]=data[c];
+    }
+  }
+  if(row%chunkRows==chunkRows-1) {
+    ds->append(stats.data());
+    resetStats();
+  }
+}
+
+vector<hsize_t> ZoneMap::findRows(ZoneMap *zoneMap, int column, hsize_t rows, hsize_t chunkRows,
+                                  const function<bool(double, double, double)> &mayMatch,
+                                  const function<bool(double)> &pred, const ReadColumn &readColumn, size_t *chunksRead) {
+  vector<hsize_t> ret;
+  size_t nRead=0;
+  // scan the rows [begin, end[
+  auto scan=[&](hsize_t begin, hsize_t end) {
+    nRead+=(end-begin+chunkRows-1)/chunkRows;
+    // read at most 256 chunks at once
+    for(hsize_t b=begin; b<end; b+=256*chunkRows) {
+      hsize_t e=min(end, b+256*chunkRows);
+      vector<double> data=readColumn(b, e);
+      for(hsize_t r=b; r<e; ++r)
+        if(pred(data[r-b]))
+          ret.push_back(r);
+    }
+  };
+
+  hsize_t indexedRows=0;
+  if(zoneMap) {
+    hsize_t nChunks=min(zoneMap->ds->getRows(), rows/chunkRows);
+    vector<double> stats=zoneMap->ds->read(0, nChunks, 3*column, 1, 3);
+    // read consecutive chunks which may match at once
+    hsize_t begin=0;
+    for(hsize_t c=0; c<nChunks; ++c)
+      if(!mayMatch(stats[3*c+0], stats[3*c+1], stats[3*c+2])) {
+        scan(begin, c*chunkRows);
+        begin=(c+1)*chunkRows;
+      }
+    scan(begin, nChunks*chunkRows);
+    indexedRows=nChunks*chunkRows;
+  }
+  // the rows not covered by the zone map
+  scan(indexedRows, rows);
+  if(chunksRead)
+    *chunksRead=nRead;
+  return ret;
+}
+
+}
@@ -0,0 +1,73 @@
+/* Copyright (C) 2026 Markus Friedrich
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * Contact:
+ *   friedrich.at.gc@googlemail.com
+ *
+ */
+
+#ifndef _HDF5SERIE_ZONEMAP_H_
+#define _HDF5SERIE_ZONEMAP_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "companiondataset.h"
+
+namespace H5 {
+
+// Per chunk statistics of all columns of a VectorSerie, see VectorSerie::enableZoneMap.
+// For each complete chunk of the serie the min value, the max value and the number of NaN values of each column
+// is stored in a CompanionDataset with the kind "zonemap" (columns 3*c, 3*c+1, 3*c+2 for column c of the serie).
+// The companion dataset is chunked by column such that the statistics of a single column can be read cheaply.
+class ZoneMap {
+  public:
+    // create a new zone map for the serie name in parent with cols_ columns and chunks of chunkRows_ rows
+    ZoneMap(hid_t parent, const std::string &name, int cols_, hsize_t chunkRows_, int compression);
+    // open the zone map of the serie name in parent; nullptr if the serie has no zone map
+    static std::shared_ptr<ZoneMap> open(hid_t parent, const std::string &name, hsize_t chunkRows_);
+
+    void close();
+    void reopen(hid_t parent);
+    void flush();
+    void refresh();
+
+    // add the row row of the serie (rows must be added in order)
+    void append(hsize_t row, const double *data);
+
+    // returns all rows r of [0, rows[ for which pred(value of column in row r) is true.
+    // chunks for which mayMatch(min, max, nanCount) is false are skipped.
+    // readColumn(begin, end) must return the values of column for the rows [begin, end[.
+    // zoneMap may be nullptr: then the complete column is read.
+    using ReadColumn = std::function<std::vector<double>(hsize_t, hsize_t)>;
+    static std::vector<hsize_t> findRows(ZoneMap *zoneMap, int column, hsize_t rows, hsize_t chunkRows,
+                                         const std::function<bool(double, double, double)> &mayMatch,
+                                         const std::function<bool(double)> &pred, const ReadColumn &readColumn,
+                                         size_t *chunksRead=nullptr);
+
+  private:
+    ZoneMap(int cols_, hsize_t chunkRows_);
+    int cols;
+    hsize_t chunkRows;
+    std::unique_ptr<CompanionDataset> ds;
+    std::vector<double> stats; // the statistics of the current chunk (writer side)
+    void resetStats();
+};
+
+}
+
+#endif